@@ -32,6 +32,18 @@
 using namespace Gecode;
 using namespace Gecode::Int;
 
+/*
+ * Filtering algorithms for the no-overlap propagator
+ *
+ * Both algorithms apply the same rule to a pair (i,j) of rectangles:
+ * if j cannot be on three of the four sides of i, then it must be on
+ * the fourth one. They only differ in how the pairs are found.
+ */
+enum NoOverlapFilter {
+  NOOVERLAP_PAIRWISE, ///< Check every pair of rectangles (quadratic)
+  NOOVERLAP_SWEEP     ///< Sweep over the compulsory parts (sort-based)
+};
+
 // The no-overlap propagator
 class NoOverlap : public Propagator {
 protected:
@@ -43,29 +55,120 @@ protected:
   ViewArray<IntView> y;
   // The heights (array)
   int* h;
+  // The filtering algorithm
+  NoOverlapFilter f;
+  // Rectangles sorted by start of compulsory part along x (sweep only)
+  int* xo;
+  // Rectangles sorted by start of compulsory part along y (sweep only)
+  int* yo;
+
+  // Order rectangles by start of their compulsory part along an axis
+  class StartLess {
+  protected:
+    const ViewArray<IntView>& u;
+  public:
+    StartLess(const ViewArray<IntView>& u0) : u(u0) {}
+    bool operator ()(int i, int j) const {
+      return u[i].max() < u[j].max();
+    }
+  };
+
+  /*
+   * Sweep along the axis u (sizes su) and prune the other axis v
+   * (sizes sv).
+   *
+   * Two rectangles i and j are forced to overlap on u if and only if
+   * the intervals [u.max(), u.min()+su) of i and j intersect. Only such
+   * pairs can prune v, as they must then be apart on v. With the
+   * rectangles sorted by u.max(), the rectangles that can be forced to
+   * overlap with i and come after i form a contiguous block. The order
+   * is kept between runs and sorted again by insertion, so one run
+   * costs O(n + d + k) for d rectangles out of order and k inspected
+   * pairs, which is quadratic in the worst case.
+   */
+  static ExecStatus sweep(Space& home,
+                          ViewArray<IntView>& u, int su[],
+                          ViewArray<IntView>& v, int sv[],
+                          int o[], bool& modified) {
+    int n=u.size();
+    StartLess lt(u);
+    Support::insertion(o,n,lt);
+    for (int a=0; a<n-1; a++) {
+      int i=o[a];
+      int ei=u[i].min()+su[i]; // end of the interval of i
+      for (int b=a+1; (b<n) && (u[o[b]].max() < ei); b++) {
+        int j=o[b];
+        if (u[i].max() < u[j].min()+su[j]) {
+          // i and j overlap on u, so they must be apart on v
+          if (v[j].min() + sv[j] > v[i].max())        // j cannot be before
+            GECODE_ME_CHECK_MODIFIED(modified,
+                                     v[j].gq(home, v[i].min()+sv[i]));
+          if (v[i].min() + sv[i] > v[j].max())        // j cannot be after
+            GECODE_ME_CHECK_MODIFIED(modified,
+                                     v[i].gq(home, v[j].min()+sv[j]));
+        }
+      }
+    }
+    return ES_OK;
+  }
+
+  // Check all pairs of rectangles
+  ExecStatus pairwise(Space& home, bool& modified) {
+    int n = x.size();
+    for (int i=0; i<n-1; i++) {
+      for (int j = i + 1; j < n; j++) {
+        bool left  = x[j].min() + w[j] > x[i].max(); // j cannot be left
+        bool right = x[i].min() + w[i] > x[j].max(); // j cannot be right
+        bool down  = y[j].min() + h[j] > y[i].max(); // j cannot be down
+        bool up    = y[i].min() + h[i] > y[j].max(); // j cannot be up
+        if (left && right && down)  // j is up
+          GECODE_ME_CHECK_MODIFIED(modified,
+                                   y[j].gq(home, y[i].min()+h[i]));
+        if (left && right && up)    // j is down
+          GECODE_ME_CHECK_MODIFIED(modified,
+                                   y[i].gq(home, y[j].min()+h[j]));
+        if (left && up && down)     // j is right
+          GECODE_ME_CHECK_MODIFIED(modified,
+                                   x[j].gq(home, x[i].min()+w[i]));
+        if (right && up && down)    // j is left
+          GECODE_ME_CHECK_MODIFIED(modified,
+                                   x[i].gq(home, x[j].min()+w[j]));
+      }
+    }
+    return ES_OK;
+  }
 
 public:
   // Create propagator and initialize
-  NoOverlap(Home home, 
-            ViewArray<IntView>& x0, int w0[], 
-            ViewArray<IntView>& y0, int h0[])
-    : Propagator(home), x(x0), w(w0), y(y0), h(h0) {
+  NoOverlap(Home home,
+            ViewArray<IntView>& x0, int w0[],
+            ViewArray<IntView>& y0, int h0[],
+            NoOverlapFilter f0)
+    : Propagator(home), x(x0), w(w0), y(y0), h(h0), f(f0),
+      xo(NULL), yo(NULL) {
+    if (f == NOOVERLAP_SWEEP) {
+      xo = static_cast<Space&>(home).alloc<int>(x.size());
+      yo = static_cast<Space&>(home).alloc<int>(y.size());
+      for (int i=x.size(); i--; )
+        xo[i]=yo[i]=i;
+    }
     x.subscribe(home,*this,PC_INT_BND);
     y.subscribe(home,*this,PC_INT_BND);
   }
   // Post no-overlap propagator
-  static ExecStatus post(Home home, 
-                         ViewArray<IntView>& x, int w[], 
-                         ViewArray<IntView>& y, int h[]) {
+  static ExecStatus post(Home home,
+                         ViewArray<IntView>& x, int w[],
+                         ViewArray<IntView>& y, int h[],
+                         NoOverlapFilter f) {
     // Only if there is something to propagate
     if (x.size() > 1)
-      (void) new (home) NoOverlap(home,x,w,y,h);
+      (void) new (home) NoOverlap(home,x,w,y,h,f);
     return ES_OK;
   }
 
   // Copy constructor during cloning
   NoOverlap(Space& home, bool share, NoOverlap& p)
-    : Propagator(home,share,p) {
+    : Propagator(home,share,p), f(p.f), xo(NULL), yo(NULL) {
     x.update(home,share,p.x);
     y.update(home,share,p.y);
     // Also copy width and height arrays
@@ -74,50 +177,46 @@ public:
     for (int i=x.size(); i--; ) {
       w[i]=p.w[i]; h[i]=p.h[i];
     }
+    // Keep the sweep orders, they are almost sorted
+    if (f == NOOVERLAP_SWEEP) {
+      xo = home.alloc<int>(x.size());
+      yo = home.alloc<int>(y.size());
+      for (int i=x.size(); i--; ) {
+        xo[i]=p.xo[i]; yo[i]=p.yo[i];
+      }
+    }
   }
   // Create copy during cloning
   virtual Propagator* copy(Space& home, bool share) {
     return new (home) NoOverlap(home,share,*this);
   }
 
-  // Return cost (defined as cheap quadratic)
+  // Return cost (cheap quadratic, or linear when sweeping)
   virtual PropCost cost(const Space&, const ModEventDelta&) const {
+    if (f == NOOVERLAP_SWEEP)
+      return PropCost::linear(PropCost::HI, 2*x.size());
     return PropCost::quadratic(PropCost::LO, 2*x.size());
   }
 
   // Perform propagation
   virtual ExecStatus propagate(Space& home, const ModEventDelta&) {
-    // TODO: complete this function
-
-    int n = x.size();
-    bool subSumed = true;
-    for (auto xItr: x) {
-      subSumed &= xItr.assigned();
-    }
-    for (auto yIter: y) {
-      subSumed &= yIter.assigned();
-    }
-    if (subSumed) {
-      return home.ES_SUBSUMED(* this);
-    }
-
-    for (int i=0; i<n-1; i++) {
-      for (int j = i + 1; j < n - 1; j++) {
-        bool overlapped =
-            x[i].gq(home, x[j].min()+w[j]) == Int::ME_INT_FAILED &&
-            x[j].gq(home, x[i].min()+w[i]) == Int::ME_INT_FAILED &&
-            y[i].gq(home, y[j].min()+h[j]) == Int::ME_INT_FAILED &&
-            y[j].gq(home, y[i].min()+h[i]) == Int::ME_INT_FAILED;
-        if (overlapped)
-          return ES_FAILED;
+    // Repeat until no bound changes, the propagator is then at fixpoint
+    bool modified;
+    do {
+      modified = false;
+      if (f == NOOVERLAP_SWEEP) {
+        // Overlapping on x prunes y, overlapping on y prunes x
+        GECODE_ES_CHECK(sweep(home,x,w,y,h,xo,modified));
+        GECODE_ES_CHECK(sweep(home,y,h,x,w,yo,modified));
+      } else {
+        GECODE_ES_CHECK(pairwise(home,modified));
       }
-    }
-    return ES_OK;
+    } while (modified);
 
-    return ES_NOFIX;
+    // All pairs have been checked, fixed squares do not overlap
+    if (x.assigned() && y.assigned())
+      return home.ES_SUBSUMED(*this);
     return ES_FIX;
-    return ES_NOFIX_FORCE;
-    return __ES_PARTIAL;
   }
 
   // Dispose propagator and return its size
@@ -133,12 +232,13 @@ public:
  * Post the constraint that the rectangles defined by the coordinates
  * x and y and width w and height h do not overlap.
  *
- * This is the function that you will call from your model. The best
- * is to paste the entire file into your model.
+ * The filtering algorithm f selects how the pairs of rectangles are
+ * inspected (see NoOverlapFilter).
  */
-void nooverlap(Home home, 
-               const IntVarArgs& x, const IntArgs& w,
-               const IntVarArgs& y, const IntArgs& h) {
+void nooverlap2(Home home,
+                const IntVarArgs& x, const IntArgs& w,
+                const IntVarArgs& y, const IntArgs& h,
+                NoOverlapFilter f=NOOVERLAP_SWEEP) {
   // Check whether the arguments make sense
   if ((x.size() != y.size()) || (x.size() != w.size()) ||
       (y.size() != h.size()))
@@ -155,6 +255,6 @@ void nooverlap(Home home,
     wc[i]=w[i]; hc[i]=h[i];
   }
   // If posting failed, fail space
-  if (NoOverlap::post(home,vx,wc,vy,hc) != ES_OK)
+  if (NoOverlap::post(home,vx,wc,vy,hc,f) != ES_OK)
     home.fail();
 }
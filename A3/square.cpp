@@ -25,13 +25,16 @@
  *
  * 
  *
- *  This file contains both the class NoOverlap and the class Square
+ *  This file contains the class Square, the class NoOverlap is in
+ *  no-overlap.cpp
  *  Execution command: ./square n
  *  with n the size of the biggest square
  *  
  *  Options:
  *  "- model noprop" (default) does not use the external nooverlap propagator
  *  "- model prop" uses the external propagator from the overlap class
+ *  "- propagation sweep/pairwise" how the propagator finds the pairs of
+ *  squares to check (with "- model prop")
  *  "- branching x/big/left/top/interval/split" for the different branching
  *  options (see details below)
  *  The best option we have found is "split", which gives for instance 133000
@@ -39,6 +42,7 @@
  */
 
 #include <gecode/driver.hh>
+#include "no-overlap.cpp"
 
 using namespace Gecode;
 using namespace Gecode::Int;
@@ -47,153 +51,6 @@ namespace {
   int n = 0; // size of the biggest square
 }
 
-// The no-overlap propagator
-class NoOverlap : public Propagator {
-protected:
-  // The x-coordinates
-  ViewArray<IntView> x;
-  // The width (array)
-  int* w;
-  // The y-coordinates
-  ViewArray<IntView> y;
-  // The heights (array)
-  int* h;
-
-public:
-  // Create propagator and initialize
-  NoOverlap(Home home,
-            ViewArray<IntView>& x0, int w0[],
-            ViewArray<IntView>& y0, int h0[])
-      : Propagator(home), x(x0), w(w0), y(y0), h(h0) {
-    x.subscribe(home,*this,PC_INT_BND);
-    y.subscribe(home,*this,PC_INT_BND);
-  }
-  // Post no-overlap propagator
-  static ExecStatus post(Home home,
-                         ViewArray<IntView>& x, int w[],
-                         ViewArray<IntView>& y, int h[]) {
-    // Only if there is something to propagate
-    if (x.size() > 1)
-      (void) new (home) NoOverlap(home,x,w,y,h);
-    return ES_OK;
-  }
-
-  // Copy constructor during cloning
-  NoOverlap(Space& home, bool share, NoOverlap& p)
-      : Propagator(home,share,p) {
-    x.update(home,share,p.x);
-    y.update(home,share,p.y);
-    // Also copy width and height arrays
-    w = home.alloc<int>(x.size());
-    h = home.alloc<int>(y.size());
-    for (int i=x.size(); i--; ) {
-      w[i]=p.w[i]; h[i]=p.h[i];
-    }
-  }
-  // Create copy during cloning
-  virtual Propagator* copy(Space& home, bool share) {
-    return new (home) NoOverlap(home,share,*this);
-  }
-
-  // Return cost (defined as cheap quadratic)
-  virtual PropCost cost(const Space&, const ModEventDelta&) const {
-    return PropCost::quadratic(PropCost::LO, 2*x.size());
-  }
-
-  // Perform propagation
-  virtual ExecStatus propagate(Space& home, const ModEventDelta&) {
-    int n=x.size();
-    for (int i=0; i<n-1; i++) {
-      for (int j = i + 1; j < n; j++) {
-	//if j can't be left, right, or down, then must be up
-	if ((x[j].min() + w[j] > x[i].max()) && // j cannot be left
-	    (x[i].min() + w[i] > x[j].max()) && // j cannot be right
-	    (y[j].min() + h[j] > y[i].max()))   // j cannot be down
-	  GECODE_ME_CHECK(y[j].gq(home, y[i].min()+h[i])); // j is up
-
-	//if j can't be left, right, or up, then must be down
-	if ((x[j].min() + w[j] > x[i].max()) && // j cannot be left
-	    (x[i].min() + w[i] > x[j].max()) && // j cannot be right
-	    (y[i].min() + h[i] > y[j].max()))   // j cannot be up
-	  GECODE_ME_CHECK(y[i].gq(home, y[j].min()+h[j])); // j is down
-
-	//if j can't be left, up, or down, then must be right
-	if ((x[j].min() + w[j] > x[i].max()) && // j cannot be left
-	    (y[i].min() + h[i] > y[j].max()) && // j cannot be up
-	    (y[j].min() + h[j] > y[i].max()))   // j cannot be down
-	  GECODE_ME_CHECK(x[j].gq(home, x[i].min()+w[i])); // j is right
-
-	//if j can't be right, up, or down, then must be left
-	if ((x[i].min() + w[i] > x[j].max()) && // j cannot be right
-	    (y[i].min() + h[i] > y[j].max()) && // j cannot be up
-	    (y[j].min() + h[j] > y[i].max()))   // j cannot be down
-	  GECODE_ME_CHECK(x[i].gq(home, x[j].min()+w[j])); // j is left
-      }
-    }
-
-    bool subsumed = false;
-    int i,j=0;
-    while (subsumed && i<x.size()-1){
-      subsumed =
-	(x[j].min() >= x[i].max()+w[i]) || // j is on the right of i
-	(x[i].min() >= x[j].max()+w[j]) || // j is on the left of i
-	(y[j].min() >= y[i].max()+h[i]) || // j is above i
-	(y[i].min() >= y[j].max()+h[j]);   // j is below i
-      if (++j >= x.size()){
-	i++;
-	j=i+1;
-      }
-    }
-
-    if (subsumed)
-      return home.ES_SUBSUMED(*this);
-    else
-      return ES_FIX;
-  }
-
-  // Dispose propagator and return its size
-  virtual size_t dispose(Space& home) {
-    x.cancel(home,*this,PC_INT_BND);
-    y.cancel(home,*this,PC_INT_BND);
-    (void) Propagator::dispose(home);
-    return sizeof(*this);
-  }
-}; // end of class NoOverlap
-
-/*
- * Post the constraint that the rectangles defined by the coordinates
- * x and y and width w and height h do not overlap.
- *
- * This is the function that you will call from your model. The best
- * is to paste the entire file into your model.
- */
-void nooverlap2(Home home,
-               const IntVarArgs& x, const IntArgs& w,
-               const IntVarArgs& y, const IntArgs& h) {
-  // Check whether the arguments make sense
-  if ((x.size() != y.size()) || (x.size() != w.size()) ||
-      (y.size() != h.size()))
-    throw ArgumentSizeMismatch("nooverlap");
-  // Never post a propagator in a failed space
-  if (home.failed()) return;
-  // Set up array of views for the coordinates
-  ViewArray<IntView> vx(home,x);
-  ViewArray<IntView> vy(home,y);
-  // Set up arrays (allocated in home) for width and height and initialize
-  int* wc = static_cast<Space&>(home).alloc<int>(x.size());
-  int* hc = static_cast<Space&>(home).alloc<int>(y.size());
-  for (int i=x.size(); i--; ) {
-    wc[i]=w[i]; hc[i]=h[i];
-  }
-  // If posting failed, fail space
-  if (NoOverlap::post(home,vx,wc,vy,hc) != ES_OK)
-    home.fail();
-}
-
-
-
-
-
 class Square : public Script {
 protected:
   IntVar s;      // side of the enclosing box
@@ -314,7 +171,8 @@ public:
 
       nooverlap2(*this,
 		IntVarArgs(x), IntArgs(n-1, sArr),
-		IntVarArgs(y), IntArgs(n-1, sArr));
+		IntVarArgs(y), IntArgs(n-1, sArr),
+		static_cast<NoOverlapFilter>(opt.propagation()));
       break;
     }
 
@@ -409,6 +267,12 @@ int main(int argc, char* argv[]) {
   opt.model(Square::MODEL_PROP, 
             "prop", "use extern no-overlap propagator");
   opt.model(Square::MODEL_NO_PROP);
+
+  opt.propagation(NOOVERLAP_SWEEP);
+  opt.propagation(NOOVERLAP_PAIRWISE,
+                  "pairwise", "check all pairs of squares");
+  opt.propagation(NOOVERLAP_SWEEP,
+                  "sweep", "sweep over compulsory parts");
   
   opt.parse(argc,argv);
   if (opt.size() < 2) {
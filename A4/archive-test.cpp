@@ -0,0 +1,146 @@
+/*
+ *  Main author:
+ *     Yumen & Marion
+ *
+ *  Copyright:
+ *     Yumen & Marion, 2026
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining
+ *  a copy of this software and associated documentation files (the
+ *  "Software"), to deal in the Software without restriction, including
+ *  without limitation the rights to use, copy, modify, merge, publish,
+ *  distribute, sublicense, and/or sell copies of the Software, and to
+ *  permit persons to whom the Software is furnished to do so, subject to
+ *  the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be
+ *  included in all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ *  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ *  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ *  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+/*
+ * Round trip of the choices of the interval and grid branchings
+ *
+ * A choice is archived, rebuilt from the archive, and archived again.
+ * Both archives must be equal (for the interval branching they hold
+ * pos, min, max, and length, for the grid branching pos, the number of
+ * cells, the minimum values, and the cell sizes), as must the number
+ * of alternatives. Committing every alternative of either choice must
+ * leave the same bounds. This is what parallel and recomputation
+ * search rely on when they ship choices between spaces.
+ */
+
+#include <gecode/search.hh>
+#include <iostream>
+#include "interval.cpp"
+
+// Branchings under test
+enum {
+  TEST_INTERVAL,          ///< interval branching, fixed percentage
+  TEST_INTERVAL_ADAPTIVE, ///< interval branching, adaptive percentage
+  TEST_GRID               ///< grid branching
+};
+
+// Space with one branching on a few rectangles
+class Branching : public Space {
+public:
+  IntVarArray x, y;
+  Branching(int b) : x(*this, 4, 0, 40), y(*this, 4, 0, 40) {
+    IntArgs w(4, 10,8,6,5);
+    switch (b) {
+    case TEST_INTERVAL:
+      interval(*this, x, w, 0.2, INTERVAL_RATIO_MAX);
+      break;
+    case TEST_INTERVAL_ADAPTIVE:
+      interval(*this, x, w, 0.1, 0.4, INTERVAL_AFC_MAX);
+      break;
+    default:
+      grid(*this, x, w, y, w, 0.2, GRID_REGION_MIN);
+      break;
+    }
+  }
+  Branching(bool share, Branching& b) : Space(share, b) {
+    x.update(*this, share, b.x);
+    y.update(*this, share, b.y);
+  }
+  virtual Space* copy(bool share) {
+    return new Branching(share, *this);
+  }
+  // Return whether the bounds of all coordinates equal the ones of b
+  bool same(const Branching& b) const {
+    for (int i=0; i<x.size(); i++)
+      if ((x[i].min() != b.x[i].min()) || (x[i].max() != b.x[i].max()) ||
+          (y[i].min() != b.y[i].min()) || (y[i].max() != b.y[i].max()))
+        return false;
+    return true;
+  }
+};
+
+// Check the round trip of choices for branching b along one path
+int check(const char* name, int b) {
+  int errors = 0;
+  Branching* s = new Branching(b);
+  for (int depth=0; (s->status() == SS_BRANCH) && (depth < 10); depth++) {
+    const Choice* c = s->choice();
+    Archive a;
+    c->archive(a);
+    const Choice* d = s->choice(a);
+    Archive e;
+    d->archive(e);
+    if (c->alternatives() != d->alternatives()) {
+      std::cerr << name << ": alternatives differ at depth " << depth
+                << std::endl;
+      errors++;
+    }
+    if (a.size() != e.size()) {
+      std::cerr << name << ": archive sizes differ at depth " << depth
+                << std::endl;
+      errors++;
+    } else {
+      for (int i=0; i<a.size(); i++)
+        if (a[i] != e[i]) {
+          std::cerr << name << ": archive entry " << i
+                    << " differs at depth " << depth << std::endl;
+          errors++;
+        }
+    }
+    for (unsigned int alt=0; alt<c->alternatives(); alt++) {
+      Branching* u = static_cast<Branching*>(s->clone());
+      Branching* v = static_cast<Branching*>(s->clone());
+      u->commit(*c, alt);
+      v->commit(*d, alt);
+      SpaceStatus su = u->status(), sv = v->status();
+      if ((su != sv) || ((su != SS_FAILED) && !u->same(*v))) {
+        std::cerr << name << ": alternative " << alt
+                  << " differs at depth " << depth << std::endl;
+        errors++;
+      }
+      delete u; delete v;
+    }
+    // Follow the middle alternative
+    s->commit(*c, c->alternatives()/2);
+    delete c; delete d;
+  }
+  delete s;
+  return errors;
+}
+
+int main(void) {
+  int errors = check("interval", TEST_INTERVAL) +
+    check("interval (adaptive)", TEST_INTERVAL_ADAPTIVE) +
+    check("grid", TEST_GRID);
+  if (errors > 0) {
+    std::cerr << errors << " errors" << std::endl;
+    return 1;
+  }
+  std::cout << "All choices survive the archive" << std::endl;
+  return 0;
+}
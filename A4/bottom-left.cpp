@@ -0,0 +1,170 @@
+/*
+ *  Main author:
+ *     Yumen & Marion
+ *
+ *  Copyright:
+ *     Yumen & Marion, 2026
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining
+ *  a copy of this software and associated documentation files (the
+ *  "Software"), to deal in the Software without restriction, including
+ *  without limitation the rights to use, copy, modify, merge, publish,
+ *  distribute, sublicense, and/or sell copies of the Software, and to
+ *  permit persons to whom the Software is furnished to do so, subject to
+ *  the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be
+ *  included in all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ *  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ *  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ *  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+#include <gecode/int.hh>
+#include <algorithm>
+
+using namespace Gecode;
+using namespace Gecode::Int;
+
+/*
+ * The bottom-left dominance propagator
+ *
+ * Squares at x[i] and y[i] with sizes s[i] that do not overlap can
+ * be pushed left and down as long as there is free space next to
+ * them. Pushing only ever decreases the coordinates, so every packing
+ * can be turned into one where no square can be pushed any further:
+ * every square either touches the left border or the right side of a
+ * square overlapping it in y, and either touches the bottom border or
+ * the top side of a square overlapping it in x.
+ *
+ * The propagator only keeps such packings. A square i can touch the
+ * right side of j at the coordinates [x[j].min()+s[j],x[j].max()+s[j]]
+ * (if they can overlap in y), so the bounds of x[i] are moved to the
+ * closest coordinate that is 0 or in one of these intervals (and the
+ * same for y).
+ */
+class BottomLeft : public Propagator {
+protected:
+  // The x coordinates
+  ViewArray<IntView> x;
+  // The y coordinates
+  ViewArray<IntView> y;
+  // The sizes (array)
+  int* s;
+
+  // Return whether i and j can overlap in the interval axis a
+  bool overlapping(const ViewArray<IntView>& a, int i, int j) const {
+    return (a[j].min() < a[i].max()+s[i]) && (a[i].min() < a[j].max()+s[j]);
+  }
+  /*
+   * Tighten the bounds of a[i] such that square i touches the border
+   * or the side of a square that may overlap it in the other axis b
+   */
+  ExecStatus support(Space& home, ViewArray<IntView>& a,
+                     const ViewArray<IntView>& b, int i, bool& modified) {
+    int lo = a[i].min(), hi = a[i].max();
+    // Smallest and largest supported coordinate in [lo,hi]
+    int l = (lo == 0) ? 0 : Int::Limits::max;
+    int u = (lo == 0) ? 0 : Int::Limits::min;
+    for (int j=0; j<a.size(); j++) {
+      if ((j == i) || !overlapping(b,i,j))
+        continue;
+      int cl = std::max(lo, a[j].min()+s[j]);
+      int cu = std::min(hi, a[j].max()+s[j]);
+      if (cl <= cu) {
+        l = std::min(l,cl); u = std::max(u,cu);
+      }
+    }
+    if (l > u)
+      return ES_FAILED;
+    GECODE_ME_CHECK_MODIFIED(modified, a[i].gq(home,l));
+    GECODE_ME_CHECK_MODIFIED(modified, a[i].lq(home,u));
+    return ES_OK;
+  }
+
+public:
+  // Create propagator and initialize
+  BottomLeft(Home home, ViewArray<IntView>& x0, ViewArray<IntView>& y0,
+             int s0[])
+    : Propagator(home), x(x0), y(y0), s(s0) {
+    x.subscribe(home,*this,PC_INT_BND);
+    y.subscribe(home,*this,PC_INT_BND);
+  }
+  // Post bottom-left propagator
+  static ExecStatus post(Home home, ViewArray<IntView>& x,
+                         ViewArray<IntView>& y, int s[]) {
+    // Only if there is something to propagate
+    if (x.size() > 0)
+      (void) new (home) BottomLeft(home,x,y,s);
+    return ES_OK;
+  }
+
+  // Copy constructor during cloning
+  BottomLeft(Space& home, bool share, BottomLeft& p)
+    : Propagator(home,share,p) {
+    x.update(home,share,p.x);
+    y.update(home,share,p.y);
+    // Also copy size array
+    s = home.alloc<int>(x.size());
+    for (int i=x.size(); i--; )
+      s[i]=p.s[i];
+  }
+  // Create copy during cloning
+  virtual Propagator* copy(Space& home, bool share) {
+    return new (home) BottomLeft(home,share,*this);
+  }
+
+  // Return cost (all pairs of squares)
+  virtual PropCost cost(const Space&, const ModEventDelta&) const {
+    return PropCost::quadratic(PropCost::LO, 2*x.size());
+  }
+
+  // Perform propagation
+  virtual ExecStatus propagate(Space& home, const ModEventDelta&) {
+    bool modified=false;
+    for (int i=0; i<x.size(); i++) {
+      GECODE_ES_CHECK(support(home,x,y,i,modified));
+      GECODE_ES_CHECK(support(home,y,x,i,modified));
+    }
+    // Once all squares are fixed every one has been checked
+    if (x.assigned() && y.assigned())
+      return home.ES_SUBSUMED(*this);
+    return modified ? ES_NOFIX : ES_FIX;
+  }
+
+  // Dispose propagator and return its size
+  virtual size_t dispose(Space& home) {
+    x.cancel(home,*this,PC_INT_BND);
+    y.cancel(home,*this,PC_INT_BND);
+    (void) Propagator::dispose(home);
+    return sizeof(*this);
+  }
+}; // end of class BottomLeft
+
+/*
+ * Post the constraint that the squares at x and y with sizes s are in
+ * bottom-left normal form: no square can be pushed left or down.
+ */
+void bottomleft(Home home,
+                const IntVarArgs& x, const IntVarArgs& y, const IntArgs& s) {
+  // Check whether the arguments make sense
+  if ((x.size() != y.size()) || (x.size() != s.size()))
+    throw ArgumentSizeMismatch("bottomleft");
+  // Never post a propagator in a failed space
+  if (home.failed()) return;
+  // Set up arrays of views for the coordinates
+  ViewArray<IntView> vx(home,x);
+  ViewArray<IntView> vy(home,y);
+  // Set up array (allocated in home) for the sizes
+  int* sc = static_cast<Space&>(home).alloc<int>(x.size());
+  for (int i=x.size(); i--; )
+    sc[i]=s[i];
+  // If posting failed, fail space
+  if (BottomLeft::post(home,vx,vy,sc) != ES_OK)
+    home.fail();
+}
@@ -0,0 +1,208 @@
+/*
+ *  Main author:
+ *     Yumen & Marion
+ *
+ *  Copyright:
+ *     Yumen & Marion, 2026
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining
+ *  a copy of this software and associated documentation files (the
+ *  "Software"), to deal in the Software without restriction, including
+ *  without limitation the rights to use, copy, modify, merge, publish,
+ *  distribute, sublicense, and/or sell copies of the Software, and to
+ *  permit persons to whom the Software is furnished to do so, subject to
+ *  the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be
+ *  included in all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ *  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ *  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ *  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include <gecode/int.hh>
+#include <algorithm>
+
+using namespace Gecode;
+using namespace Gecode::Int;
+
+/*
+ * The cumulative (timetable) propagator
+ *
+ * Tasks start at x[i], last w[i] and use h[i] of a resource with
+ * capacity c. At no point may the tasks running use more than c.
+ *
+ * Projected on one axis, rectangles that do not overlap form such a
+ * resource: every column is crossed by squares of total height at most
+ * the side of the enclosing box.
+ *
+ * The propagator builds the profile of the compulsory parts
+ * [x.max(), x.min()+w) of the tasks. The highest point of the profile
+ * is a lower bound for c. A task that would exceed c.max() when placed
+ * on a segment of the profile cannot overlap that segment, and the
+ * corresponding start times are removed from x.
+ */
+class Cumulative : public Propagator {
+protected:
+  // The start times
+  ViewArray<IntView> x;
+  // The durations (array)
+  int* w;
+  // The resource usages (array)
+  int* h;
+  // The capacity
+  IntView c;
+
+  // Event of the profile: height dh is added at time t
+  class Event {
+  public:
+    int t;
+    int dh;
+  };
+  // Order events by time
+  class EventLess {
+  public:
+    bool operator ()(const Event& a, const Event& b) const {
+      return a.t < b.t;
+    }
+  };
+
+public:
+  // Create propagator and initialize
+  Cumulative(Home home, IntView c0,
+             ViewArray<IntView>& x0, int w0[], int h0[])
+    : Propagator(home), x(x0), w(w0), h(h0), c(c0) {
+    x.subscribe(home,*this,PC_INT_BND);
+    c.subscribe(home,*this,PC_INT_BND);
+  }
+  // Post cumulative propagator
+  static ExecStatus post(Home home, IntView c,
+                         ViewArray<IntView>& x, int w[], int h[]) {
+    // Only if there is something to propagate
+    if (x.size() > 0)
+      (void) new (home) Cumulative(home,c,x,w,h);
+    return ES_OK;
+  }
+
+  // Copy constructor during cloning
+  Cumulative(Space& home, bool share, Cumulative& p)
+    : Propagator(home,share,p) {
+    x.update(home,share,p.x);
+    c.update(home,share,p.c);
+    // Also copy duration and usage arrays
+    w = home.alloc<int>(x.size());
+    h = home.alloc<int>(x.size());
+    for (int i=x.size(); i--; ) {
+      w[i]=p.w[i]; h[i]=p.h[i];
+    }
+  }
+  // Create copy during cloning
+  virtual Propagator* copy(Space& home, bool share) {
+    return new (home) Cumulative(home,share,*this);
+  }
+
+  // Return cost (sorting plus one scan of the profile per task)
+  virtual PropCost cost(const Space&, const ModEventDelta&) const {
+    return PropCost::quadratic(PropCost::LO, x.size());
+  }
+
+  // Perform propagation
+  virtual ExecStatus propagate(Space& home, const ModEventDelta&) {
+    int n=x.size();
+    Region r(home);
+
+    // Events for the start and the end of the compulsory parts
+    Event* e = r.alloc<Event>(2*n);
+    int ne=0;
+    for (int i=0; i<n; i++)
+      if (x[i].max() < x[i].min()+w[i]) {
+        e[ne].t=x[i].max(); e[ne].dh=h[i]; ne++;
+        e[ne].t=x[i].min()+w[i]; e[ne].dh=-h[i]; ne++;
+      }
+    EventLess lt;
+    Support::quicksort(e,ne,lt);
+
+    // The profile has height sh[k] on the segment [st[k],st[k+1])
+    int* st = r.alloc<int>(ne);
+    int* sh = r.alloc<int>(ne);
+    int ns=0;
+    int height=0, top=0;
+    for (int k=0; k<ne; ) {
+      int t=e[k].t;
+      // Handle all events at time t at once
+      while ((k < ne) && (e[k].t == t))
+        height += e[k++].dh;
+      st[ns]=t; sh[ns]=height; ns++;
+      top=std::max(top,height);
+    }
+
+    // The capacity must cover the highest point of the profile
+    GECODE_ME_CHECK(c.gq(home,top));
+
+    // Remove start times that would exceed the capacity
+    bool modified=false;
+    for (int i=0; i<n; i++) {
+      // Compulsory part of i, it is part of the profile
+      int cp0=x[i].max(), cp1=x[i].min()+w[i];
+      for (int k=0; k<ns-1; k++) {
+        if (sh[k] == 0)
+          continue;
+        // Height of the profile without i
+        int others = sh[k];
+        if ((cp0 <= st[k]) && (st[k+1] <= cp1))
+          others -= h[i];
+        if ((others + h[i] > c.max()) &&
+            (st[k]-w[i]+1 <= x[i].max()) && (st[k+1]-1 >= x[i].min())) {
+          // i must not overlap [st[k],st[k+1])
+          Iter::Ranges::Singleton o(st[k]-w[i]+1,st[k+1]-1);
+          GECODE_ME_CHECK_MODIFIED(modified, x[i].minus_r(home,o,false));
+        }
+      }
+    }
+
+    // The profile is only exact if all tasks were fixed before pruning
+    if (modified)
+      return ES_NOFIX;
+    if (x.assigned())
+      return home.ES_SUBSUMED(*this);
+    return ES_FIX;
+  }
+
+  // Dispose propagator and return its size
+  virtual size_t dispose(Space& home) {
+    x.cancel(home,*this,PC_INT_BND);
+    c.cancel(home,*this,PC_INT_BND);
+    (void) Propagator::dispose(home);
+    return sizeof(*this);
+  }
+}; // end of class Cumulative
+
+/*
+ * Post the constraint that tasks starting at x with durations w and
+ * resource usages h never use more than the capacity c at any time.
+ */
+void cumulative2(Home home, IntVar c,
+                 const IntVarArgs& x, const IntArgs& w, const IntArgs& h) {
+  // Check whether the arguments make sense
+  if ((x.size() != w.size()) || (x.size() != h.size()))
+    throw ArgumentSizeMismatch("cumulative");
+  // Never post a propagator in a failed space
+  if (home.failed()) return;
+  // Set up array of views for the start times
+  ViewArray<IntView> vx(home,x);
+  // Set up arrays (allocated in home) for durations and usages
+  int* wc = static_cast<Space&>(home).alloc<int>(x.size());
+  int* hc = static_cast<Space&>(home).alloc<int>(x.size());
+  for (int i=x.size(); i--; ) {
+    wc[i]=w[i]; hc[i]=h[i];
+  }
+  // If posting failed, fail space
+  if (Cumulative::post(home,c,vx,wc,hc) != ES_OK)
+    home.fail();
+}
@@ -27,11 +27,21 @@
  */
 
 #include <gecode/int.hh>
+#include <algorithm>
 
 using namespace Gecode;
 
 using namespace Gecode::Int;
 
+// Which view the interval brancher splits first
+enum IntervalSelect {
+  INTERVAL_FIRST,     ///< First view that can still be split
+  INTERVAL_WIDTH_MAX, ///< View with the largest width
+  INTERVAL_SIZE_MIN,  ///< View with the smallest interval left
+  INTERVAL_AFC_MAX,   ///< View with the largest AFC
+  INTERVAL_RATIO_MAX  ///< View with the largest area per interval left
+};
+
 /*
  * Custom brancher for forcing mandatory parts
  * 
@@ -41,8 +51,10 @@ using namespace Gecode::Int;
  * "split" branching option described in the paper, which first
  * splits the interval of all x[i] and y[i] variables, and then
  * assigns values to all x[i] and y[i].
-
  *
+ * Instead of a fixed percentage p the brancher can adapt it per
+ * variable between p and q (see choice_size), which avoids tuning p
+ * for each instance size.
  */
 class IntervalBrancher : public Brancher {
 protected:
@@ -50,16 +62,79 @@ protected:
   ViewArray<IntView> x;
   // Width (or height) of rectangles
   int* w;
-  // Percentage for obligatory part
+  // Percentage for obligatory part (the smallest one if adaptive)
   double p;
-  // Cache of first unassigned view
+  // Largest percentage for obligatory part (adaptive if q > p)
+  double q;
+  // Largest width (or height)
+  int wm;
+  // How to select the view
+  IntervalSelect sel;
+  /*
+   * Cache of first view that can still be split
+   *
+   * A view that cannot be split any more stays so in all descendant
+   * spaces (its domain only shrinks), so the views before start never
+   * need to be inspected again and start is kept when cloning.
+   * status() leaves start at the view to branch on, which choice()
+   * then uses without scanning again.
+   */
   mutable int start;
 
+  // Whether the view at position i can still be split
+  bool splittable(int i) const {
+    return w[i]>=5 && (x[i].max() - x[i].min() > interval_size(i));
+  }
+
   // compute the maximum size (x.max-x.min) of the new intervals
   int interval_size(int pos) const{
     return floor((1-p)*w[pos]);
   }
 
+  /*
+   * Compute the maximum size of the new intervals when branching on
+   * the view at position pos.
+   *
+   * If adaptive, the percentage is chosen between p and q: bigger
+   * rectangles, and views that have been involved in more failures
+   * than the average of the views still to split (by their AFC), get
+   * narrower intervals. The percentage is never below p, so the view
+   * is split in at least two intervals.
+   */
+  int choice_size(const Space& home, int pos) const {
+    if (q <= p)
+      return interval_size(pos);
+    // Average AFC of the views still to split
+    double a=0.0;
+    int k=0;
+    for (int i=start; i<x.size(); i++)
+      if (splittable(i)) {
+        a += x[i].afc(home); k++;
+      }
+    a /= k;
+    double f=x[pos].afc(home);
+    // Both terms are in [0,1], the AFC term is 0.5 for the average
+    double t=0.5*(static_cast<double>(w[pos])/wm +
+                  ((a > 0.0) ? f/(f+a) : 0.5));
+    return floor((1-(p+t*(q-p)))*w[pos]);
+  }
+
+  // Return merit of view at position i for selection (larger is better)
+  double merit(const Space& home, int i) const {
+    switch (sel) {
+    case INTERVAL_WIDTH_MAX:
+      return w[i];
+    case INTERVAL_SIZE_MIN:
+      return -(x[i].max() - x[i].min());
+    case INTERVAL_AFC_MAX:
+      return x[i].afc(home);
+    case INTERVAL_RATIO_MAX:
+      return (double)w[i]*w[i] / (x[i].max() - x[i].min() + 1);
+    default:
+      return 0.0;
+    }
+  }
+
   // compute the number of alternatives in the branching
   // (one for each interval)
   int alternatives(int old_interval_size, int new_interval_size){
@@ -80,12 +155,15 @@ protected:
      */
     int min;
     int max;
+    // maximum size of the new intervals
+    int length;
 
     /*
      * check initialization
      */
-    Description(const Brancher& b, unsigned int a, int p, int mn, int mx)
-      : Choice(b,a), pos(p), min(mn), max(mx) {}
+    Description(const Brancher& b, unsigned int a, int p, int mn, int mx,
+                int s)
+      : Choice(b,a), pos(p), min(mn), max(mx), length(s) {}
     // Report size occupied
     virtual size_t size(void) const {
       return sizeof(Description);
@@ -94,22 +172,29 @@ protected:
     virtual void archive(Archive& e) const {
       Choice::archive(e);
       // You must also archive the additional information
-      e << pos << min << max;
+      e << pos << min << max << length;
     }
   };
 public:
   // Construct branching
   IntervalBrancher(Home home, 
-                   ViewArray<IntView>& x0, int w0[], double p0)
-    : Brancher(home), x(x0), w(w0), p(p0), start(0) {}
+                   ViewArray<IntView>& x0, int w0[], double p0, double q0,
+                   IntervalSelect sel0)
+    : Brancher(home), x(x0), w(w0), p(p0), q(q0), wm(1), sel(sel0),
+      start(0) {
+    for (int i=x.size(); i--; )
+      wm = std::max(wm,w[i]);
+  }
   // Post branching
-  static void post(Home home, ViewArray<IntView>& x, int w[], double p) {
-    (void) new (home) IntervalBrancher(home,x,w,p);
+  static void post(Home home, ViewArray<IntView>& x, int w[],
+                   double p, double q, IntervalSelect sel) {
+    (void) new (home) IntervalBrancher(home,x,w,p,q,sel);
   }
 
   // Copy constructor used during cloning of b
   IntervalBrancher(Space& home, bool share, IntervalBrancher& b)
-    : Brancher(home, share, b), p(b.p), start(b.start) {
+    : Brancher(home, share, b), p(b.p), q(b.q), wm(b.wm), sel(b.sel),
+      start(b.start) {
     x.update(home,share,b.x);
     w = home.alloc<int>(x.size());
     for (int i=x.size(); i--; )
@@ -128,38 +213,45 @@ public:
     // the square is big enough (typically w >= 5) AND
     // the current size of the interval of values for the variable is
     // larger than the size needed to achieve "obligatory parts"
-    for (int i=0; i<x.size(); i++){
-      if (w[i]>=5 && (x[i].max() - x[i].min() > interval_size(i)))
-	return true;
-    }
+    for (int i=start; i<x.size(); i++)
+      if (splittable(i)) {
+        start=i;
+        return true;
+      }
+    start=x.size();
     return false;
 
   }
   // Return choice as description
   virtual const Choice* choice(Space& home) {
 
-    // if there is a new branching to do, initialize it with the number
-    // of alternatives, position, and initial min and max values
-    for (int i=0; true; i++)
-      if (w[i]>=5 && (x[i].max() - x[i].min() > interval_size(i))){
-	int alt = alternatives(x[i].max()-x[i].min(), interval_size(i));
-	return new Description(*this, alt,i,x[i].min(), x[i].max());
-      }
-    GECODE_NEVER;
-    return NULL;
+    // status() has left start at the first view to split, select the
+    // view to branch on from there and initialize the choice with the
+    // number of alternatives, position, and initial min and max values
+    int i = start;
+    if (sel != INTERVAL_FIRST) {
+      double m = merit(home,i);
+      for (int j=start+1; j<x.size(); j++)
+        if (splittable(j) && (merit(home,j) > m)) {
+          i = j; m = merit(home,j);
+        }
+    }
+    int size = choice_size(home,i);
+    int alt = alternatives(x[i].max()-x[i].min(), size);
+    return new Description(*this, alt, i, x[i].min(), x[i].max(), size);
 
   }
   // Construct choice from archive e
   virtual const Choice* choice(const Space&, Archive& e) {
     // Again, you have to take care of the additional information
-    int pos, min, max;
-    e >> pos >> min >> max;
+    int pos, min, max, size;
+    e >> pos >> min >> max >> size;
 
     // We use the values of min and max here in order to compute the
-    // number of alternatives
-    return new Description(*this, pos,
-                           alternatives(max-min, interval_size(pos)),
-			   min, max);
+    // number of alternatives, the result must be identical to the
+    // description archived by choice() above
+    return new Description(*this, alternatives(max-min, size), pos,
+			   min, max, size);
   }
   // Perform commit for choice c and alternative a
   virtual ExecStatus commit(Space& home, 
@@ -171,9 +263,9 @@ public:
     // depending on the alternative a
     // new_min >= old_min + a*size
     // new max < old_min + (a+1)*size
-    int pos = d.pos, min = d.min;
-    if (!me_failed(x[pos].gq(home, (int)(min+a*(interval_size(pos)+1)))) &&
-	!me_failed(x[pos].le(home, (int)(min+(a+1)*(interval_size(pos)+1)))) )
+    int pos = d.pos, min = d.min, size = d.length;
+    if (!me_failed(x[pos].gq(home, (int)(min+a*(size+1)))) &&
+	!me_failed(x[pos].le(home, (int)(min+(a+1)*(size+1)))) )
       return ES_OK;
     else
       return ES_FAILED;
@@ -190,17 +282,19 @@ public:
     // and print it
     const Description& d = static_cast<const Description&>(c);
     int pos = d.pos, min = d.min, max = d.max;
-    int size = interval_size(pos);
-    int min_val = min+b*size;
-    int max_val = min+(b+1)*size;
-    if (max < max_val)
-      max_val = max;
+    int size = d.length;
+    // Same bounds as in commit
+    int min_val = min+b*(size+1);
+    int max_val = min+(b+1)*(size+1);
+    if (max+1 < max_val)
+      max_val = max+1;
     o << min_val << " <= x[" << pos << "] <" << max_val; 
   }
 };
 
 // This posts the interval branching
-void interval(Home home, const IntVarArgs& x, const IntArgs& w, double p) {
+void interval(Home home, const IntVarArgs& x, const IntArgs& w, double p,
+              IntervalSelect sel=INTERVAL_FIRST) {
   // Check whether arguments make sense
   if (x.size() != w.size())
     throw ArgumentSizeMismatch("interval");
@@ -213,6 +307,225 @@ void interval(Home home, const IntVarArgs& x, const IntArgs& w, double p) {
   for (int i=x.size(); i--; )
     wc[i]=w[i];
   // Post the brancher
-  IntervalBrancher::post(home,vx,wc,p);
+  IntervalBrancher::post(home,vx,wc,p,p,sel);
 }
 
+/*
+ * This posts the interval branching with a percentage adapted per
+ * variable between p and q
+ */
+void interval(Home home, const IntVarArgs& x, const IntArgs& w,
+              double p, double q, IntervalSelect sel=INTERVAL_FIRST) {
+  // Check whether arguments make sense
+  if (x.size() != w.size())
+    throw ArgumentSizeMismatch("interval");
+  if ((p < 0.0) || (q < p) || (q >= 1.0))
+    throw OutOfLimits("interval");
+  // Never post a branching in a failed space
+  if (home.failed()) return;
+  // Create an array of integer views
+  ViewArray<IntView> vx(home,x);
+  // Create an array of integers
+  int* wc = static_cast<Space&>(home).alloc<int>(x.size());
+  for (int i=x.size(); i--; )
+    wc[i]=w[i];
+  // Post the brancher
+  IntervalBrancher::post(home,vx,wc,p,q,sel);
+}
+
+
+// Which rectangle the grid brancher splits first
+enum GridSelect {
+  GRID_AREA_MAX,  ///< Rectangle with the largest area
+  GRID_REGION_MIN ///< Rectangle with the smallest region left to place it
+};
+
+/*
+ * Custom brancher for forcing mandatory parts in both dimensions
+ *
+ * Instead of splitting x[i] and y[i] separately, the brancher splits
+ * both coordinates of one rectangle at once: every alternative places
+ * the rectangle in one cell of a grid, where the cells have the same
+ * sizes as the intervals of the interval brancher. A rectangle with
+ * both coordinates split has a compulsory part in both dimensions, so
+ * the no-overlap propagator can prune right away.
+ */
+class GridBrancher : public Brancher {
+protected:
+  // Views for x-coordinates and y-coordinates
+  ViewArray<IntView> x, y;
+  // Width and height of rectangles
+  int *w, *h;
+  // Percentage for obligatory part
+  double p;
+  // How to select the rectangle
+  GridSelect sel;
+  // Cache of first rectangle that can still be split (see
+  // IntervalBrancher)
+  mutable int start;
+
+  // compute the maximum size of the new intervals for size s
+  int interval_size(int s) const {
+    return floor((1-p)*s);
+  }
+  // Whether the view v of a rectangle with size s can still be split
+  bool splittable(const IntView& v, int s) const {
+    return s>=5 && (v.max() - v.min() > interval_size(s));
+  }
+  // Whether the rectangle at position i can still be split
+  bool splittable(int i) const {
+    return splittable(x[i],w[i]) || splittable(y[i],h[i]);
+  }
+  // compute the number of intervals of the view v for size s
+  int alternatives(const IntView& v, int s) const {
+    if (!splittable(v,s))
+      return 1;
+    return ceil(((double)v.max()-v.min()+1)/(interval_size(s)+1));
+  }
+  // Return whether rectangle i is better than rectangle j
+  bool better(int i, int j) const {
+    if (sel == GRID_AREA_MAX)
+      return w[i]*h[i] > w[j]*h[j];
+    return (((double)x[i].max()-x[i].min()+1)*(y[i].max()-y[i].min()+1) <
+            ((double)x[j].max()-x[j].min()+1)*(y[j].max()-y[j].min()+1));
+  }
+
+  // Description
+  class Description : public Choice {
+  public:
+    // Position of the rectangle
+    int pos;
+    // Number of cells along x
+    int nx;
+    // Minimum values of the coordinates BEFORE doing the branching
+    int xmin, ymin;
+    // Maximum size of the cells (the whole domain if not split)
+    int xlen, ylen;
+    // Initialize description for brancher b, position p, nx cells
+    // along x, and ny cells along y
+    Description(const Brancher& b, int p, int nx0, int ny0,
+                int xmn, int ymn, int xl, int yl)
+      : Choice(b,nx0*ny0), pos(p), nx(nx0),
+        xmin(xmn), ymin(ymn), xlen(xl), ylen(yl) {}
+    // Report size occupied
+    virtual size_t size(void) const {
+      return sizeof(Description);
+    }
+    // Archive the choice's information in e
+    virtual void archive(Archive& e) const {
+      Choice::archive(e);
+      e << pos << nx << alternatives()/nx << xmin << ymin << xlen << ylen;
+    }
+  };
+public:
+  // Construct branching
+  GridBrancher(Home home,
+               ViewArray<IntView>& x0, int w0[],
+               ViewArray<IntView>& y0, int h0[],
+               double p0, GridSelect sel0)
+    : Brancher(home), x(x0), y(y0), w(w0), h(h0), p(p0), sel(sel0),
+      start(0) {}
+  // Post branching
+  static void post(Home home,
+                   ViewArray<IntView>& x, int w[],
+                   ViewArray<IntView>& y, int h[],
+                   double p, GridSelect sel) {
+    (void) new (home) GridBrancher(home,x,w,y,h,p,sel);
+  }
+
+  // Copy constructor used during cloning of b
+  GridBrancher(Space& home, bool share, GridBrancher& b)
+    : Brancher(home, share, b), p(b.p), sel(b.sel), start(b.start) {
+    x.update(home,share,b.x);
+    y.update(home,share,b.y);
+    w = home.alloc<int>(x.size());
+    h = home.alloc<int>(y.size());
+    for (int i=x.size(); i--; ) {
+      w[i]=b.w[i]; h[i]=b.h[i];
+    }
+  }
+
+  // Copy brancher
+  virtual Actor* copy(Space& home, bool share) {
+    return new (home) GridBrancher(home, share, *this);
+  }
+
+  // Check status of brancher, return true if alternatives left
+  virtual bool status(const Space& home) const {
+    for (int i=start; i<x.size(); i++)
+      if (splittable(i)) {
+        start=i;
+        return true;
+      }
+    start=x.size();
+    return false;
+  }
+  // Return choice as description
+  virtual const Choice* choice(Space& home) {
+    // Select the best rectangle that can still be split
+    int i = start;
+    for (int j=start+1; j<x.size(); j++)
+      if (splittable(j) && better(j,i))
+        i = j;
+    int nx = alternatives(x[i],w[i]), ny = alternatives(y[i],h[i]);
+    int xl = (nx > 1) ? interval_size(w[i]) : x[i].max()-x[i].min();
+    int yl = (ny > 1) ? interval_size(h[i]) : y[i].max()-y[i].min();
+    return new Description(*this, i, nx, ny,
+                           x[i].min(), y[i].min(), xl, yl);
+  }
+  // Construct choice from archive e
+  virtual const Choice* choice(const Space&, Archive& e) {
+    int pos, nx, ny, xmin, ymin, xlen, ylen;
+    e >> pos >> nx >> ny >> xmin >> ymin >> xlen >> ylen;
+    return new Description(*this, pos, nx, ny, xmin, ymin, xlen, ylen);
+  }
+  // Perform commit for choice c and alternative a
+  virtual ExecStatus commit(Space& home,
+                            const Choice& c,
+                            unsigned int a) {
+    const Description& d = static_cast<const Description&>(c);
+    // The alternative a selects the cell (a % nx, a / nx)
+    int pos = d.pos;
+    int cx = a % d.nx, cy = a / d.nx;
+    int xmin = d.xmin+cx*(d.xlen+1), ymin = d.ymin+cy*(d.ylen+1);
+    GECODE_ME_CHECK(x[pos].gq(home, xmin));
+    GECODE_ME_CHECK(x[pos].le(home, xmin+d.xlen+1));
+    GECODE_ME_CHECK(y[pos].gq(home, ymin));
+    GECODE_ME_CHECK(y[pos].le(home, ymin+d.ylen+1));
+    return ES_OK;
+  }
+  // Print some information on stream o (used by Gist, from Gecode 4.0.1 on)
+  virtual void print(const Space& home, const Choice& c, unsigned int a,
+                     std::ostream& o) const {
+    const Description& d = static_cast<const Description&>(c);
+    int pos = d.pos;
+    int cx = a % d.nx, cy = a / d.nx;
+    int xmin = d.xmin+cx*(d.xlen+1), ymin = d.ymin+cy*(d.ylen+1);
+    o << xmin << " <= x[" << pos << "] <" << xmin+d.xlen+1 << ", "
+      << ymin << " <= y[" << pos << "] <" << ymin+d.ylen+1;
+  }
+};
+
+// This posts the grid branching
+void grid(Home home,
+          const IntVarArgs& x, const IntArgs& w,
+          const IntVarArgs& y, const IntArgs& h,
+          double p, GridSelect sel=GRID_AREA_MAX) {
+  // Check whether arguments make sense
+  if ((x.size() != w.size()) || (y.size() != h.size()) ||
+      (x.size() != y.size()))
+    throw ArgumentSizeMismatch("grid");
+  // Never post a branching in a failed space
+  if (home.failed()) return;
+  // Create arrays of integer views
+  ViewArray<IntView> vx(home,x);
+  ViewArray<IntView> vy(home,y);
+  // Create arrays of integers
+  int* wc = static_cast<Space&>(home).alloc<int>(x.size());
+  int* hc = static_cast<Space&>(home).alloc<int>(y.size());
+  for (int i=x.size(); i--; ) {
+    wc[i]=w[i]; hc[i]=h[i];
+  }
+  // Post the brancher
+  GridBrancher::post(home,vx,wc,vy,hc,p,sel);
+}
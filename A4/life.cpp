@@ -70,6 +70,7 @@
 
 
 #include <gecode/driver.hh>
+#include "still-life.cpp"
 
 #if defined(GECODE_HAS_QT) && defined(GECODE_HAS_GIST)
 #include <QtGui>
@@ -91,6 +92,21 @@ using namespace Gecode;
  */
 class Life : public Script {
 public:
+  /// Propagation variants
+  enum {
+    PROP_LINEAR, ///< two linear implications per cell
+    PROP_TABLE   ///< table of still 3x3 patterns (function stilllife)
+  };
+  /// Model variants
+  enum {
+    MODEL_BLOCKS, ///< at most 6 live cells per 3x3 block
+    MODEL_DP      ///< also bound by dynamic programming over rows
+  };
+  /// Search variants
+  enum {
+    SEARCH_DFS, ///< try the number of live cells from the top
+    SEARCH_BAB  ///< every solution has more live cells than the last one
+  };
 
   // dimensions of the board and borders
   int dim;
@@ -148,25 +164,33 @@ public:
       }
     }
     rel(*this, sum(csquare) == c);
+    if (opt.model() == MODEL_DP)
+      stilllifebound(*this, q, dimWithBorder, headIdx-1, tailIdx+1, c);
     
     // apply still life constraints to the board and the inner border
-    for (int i=headIdx-1; i<=tailIdx+1; i++){
-      for (int j=headIdx-1; j<=tailIdx+1; j++){
-        // sum of all the values of the neighboors of cell (i,j)
-        LinIntExpr around =
-          m(i-1,j-1) + m(i,j-1) + m(i+1,j-1) +
-          m(i-1,j) + m(i+1,j) +
-          m(i-1,j+1) + m(i,j+1) + m(i+1,j+1);
-
-        // from the paper, both CP and IP are used
-        // the constraints below are the best subset of all constraints in the trick paper
-        rel(*this, (m(i,j)==1) >> ((around == 2) || (around ==3)));
-        rel(*this, (m(i,j)==0) >> (around != 3));
+    if (opt.propagation() == PROP_TABLE) {
+      stilllife(*this, q, dimWithBorder, headIdx-1, tailIdx+1);
+    } else {
+      for (int i=headIdx-1; i<=tailIdx+1; i++){
+        for (int j=headIdx-1; j<=tailIdx+1; j++){
+          // sum of all the values of the neighboors of cell (i,j)
+          LinIntExpr around =
+            m(i-1,j-1) + m(i,j-1) + m(i+1,j-1) +
+            m(i-1,j) + m(i+1,j) +
+            m(i-1,j+1) + m(i,j+1) + m(i+1,j+1);
+
+          // from the paper, both CP and IP are used
+          // the constraints below are the best subset of all constraints in the trick paper
+          rel(*this, (m(i,j)==1) >> ((around == 2) || (around ==3)));
+          rel(*this, (m(i,j)==0) >> (around != 3));
+        }
       }
     }
 
     // First branching on c in order to maximize the number of live cells
-    branch(*this, c, INT_VAL_MAX());
+    // (branch-and-bound maximizes by constrain instead)
+    if (opt.search() == SEARCH_DFS)
+      branch(*this, c, INT_VAL_MAX());
 
     // Based on experiments,
     // AFC branching on the whole board works best for dimensions that is
@@ -204,6 +228,12 @@ public:
     return new Life(share,*this);
   }
 
+  /// Constrain to more live cells than in the best solution so far
+  virtual void
+  constrain(const Space& best) {
+    rel(*this, c > static_cast<const Life&>(best).c.val());
+  }
+
   /// Print solution
   virtual void
   print(std::ostream& os) const {
@@ -340,6 +370,24 @@ int main(int argc, char* argv[]) {
   SizeOptions opt("Life");
   opt.iterations(500);
   opt.size(5);
+  // Print every improvement, the last solution is the best one
+  opt.solutions(0);
+  opt.model(Life::MODEL_DP);
+  opt.model(Life::MODEL_BLOCKS, "blocks",
+            "at most 6 live cells per 3x3 block");
+  opt.model(Life::MODEL_DP, "dp",
+            "also bound by dynamic programming over rows");
+  opt.propagation(Life::PROP_TABLE);
+  opt.search(Life::SEARCH_BAB);
+  opt.search(Life::SEARCH_DFS, "dfs",
+             "try the number of live cells from the top "
+             "(the first solution is the best, use -solutions 1)");
+  opt.search(Life::SEARCH_BAB, "bab",
+             "every solution has more live cells than the last one");
+  opt.propagation(Life::PROP_LINEAR, "linear",
+                  "two linear implications per cell");
+  opt.propagation(Life::PROP_TABLE, "table",
+                  "table of still 3x3 patterns");
 
 #if defined(GECODE_HAS_QT) && defined(GECODE_HAS_GIST)
   LifeInspector ki;
@@ -347,6 +395,10 @@ int main(int argc, char* argv[]) {
 #endif
 
   opt.parse(argc,argv);
-  Script::run<Life,DFS,SizeOptions>(opt);
+  if (opt.search() == Life::SEARCH_BAB) {
+    Script::run<Life,BAB,SizeOptions>(opt);
+  } else {
+    Script::run<Life,DFS,SizeOptions>(opt);
+  }
   return 0;
 }
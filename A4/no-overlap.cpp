@@ -0,0 +1,1054 @@
+/*
+ *  Main author:
+ *     Christian Schulte <cschulte@kth.se>
+ *
+ *  Copyright:
+ *     Christian Schulte, 2009
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining
+ *  a copy of this software and associated documentation files (the
+ *  "Software"), to deal in the Software without restriction, including
+ *  without limitation the rights to use, copy, modify, merge, publish,
+ *  distribute, sublicense, and/or sell copies of the Software, and to
+ *  permit persons to whom the Software is furnished to do so, subject to
+ *  the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be
+ *  included in all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ *  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ *  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ *  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include <gecode/int.hh>
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// The vector kernel is compiled for AVX2 on x86 and used only if the
+// processor supports it
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define NOOVERLAP_AVX2 __attribute__((target("avx2")))
+#endif
+
+using namespace Gecode;
+using namespace Gecode::Int;
+
+/*
+ * Filtering algorithms for the no-overlap propagator
+ *
+ * All algorithms apply the same rule to a pair (i,j) of rectangles:
+ * if j cannot be on any side of i except one, then it must be on that
+ * one. They differ in how the pairs are found, the energetic algorithm
+ * also reasons on the area (or volume) of the rectangles.
+ */
+enum NoOverlapFilter {
+  NOOVERLAP_PAIRWISE,   ///< Check every pair of rectangles (quadratic)
+  NOOVERLAP_SWEEP,      ///< Sweep over the compulsory parts (sort-based)
+  NOOVERLAP_INCREMENTAL,///< Only check pairs with a modified rectangle
+  NOOVERLAP_ENERGETIC,  ///< Sweep plus energetic reasoning (cubic)
+  NOOVERLAP_SIMD        ///< Check every pair on a snapshot with AVX2
+};
+
+// Return whether the processor supports the AVX2 kernel
+inline bool nooverlapavx2(void) {
+#ifdef NOOVERLAP_AVX2
+  static const bool a = __builtin_cpu_supports("avx2");
+  return a;
+#else
+  return false;
+#endif
+}
+
+/*
+ * Statistics of the no-overlap propagator, summed over all spaces
+ *
+ * A run is one execution of the propagator by the kernel, a pass is one
+ * iteration over the rectangles within a run. Every thread that runs
+ * the propagator counts in its own record, which it registers on its
+ * first run and only it writes. The records are aligned to a cache
+ * line and only summed once the search is over. Only the no-overlap
+ * propagator is counted, so only with -model prop.
+ */
+class NoOverlapStatistics {
+public:
+  // Counts of one thread
+  class alignas(64) Counts {
+  public:
+    // Number of runs
+    unsigned long int runs;
+    // Number of passes
+    unsigned long int passes;
+    Counts(void) : runs(0), passes(0) {}
+  };
+protected:
+  // Records of all threads that have run the propagator
+  static std::vector<Counts*> threads;
+  // Mutex for registering records
+  static std::mutex m;
+public:
+  // Return the record of the calling thread
+  static Counts& local(void) {
+    // Records stay until the end, the threads may be gone by then
+    thread_local Counts* c = NULL;
+    if (c == NULL) {
+      // Plain new only aligns to a cache line from C++17 on
+      std::size_t sz = sizeof(Counts) + alignof(Counts);
+      void* p = ::operator new(sz);
+      c = new (std::align(alignof(Counts), sizeof(Counts), p, sz)) Counts;
+      std::lock_guard<std::mutex> l(m);
+      threads.push_back(c);
+    }
+    return *c;
+  }
+  // Return the number of threads that have run the propagator
+  static int size(void) {
+    std::lock_guard<std::mutex> l(m);
+    return static_cast<int>(threads.size());
+  }
+  // Return the record of thread i (only once the search is over)
+  static const Counts& thread(int i) {
+    std::lock_guard<std::mutex> l(m);
+    return *threads[i];
+  }
+  // Return the sum over all threads (only once the search is over)
+  static Counts total(void) {
+    std::lock_guard<std::mutex> l(m);
+    Counts t;
+    for (unsigned int i=0; i<threads.size(); i++) {
+      t.runs += threads[i]->runs; t.passes += threads[i]->passes;
+    }
+    return t;
+  }
+};
+std::vector<NoOverlapStatistics::Counts*> NoOverlapStatistics::threads;
+std::mutex NoOverlapStatistics::m;
+
+/*
+ * The no-overlap propagator
+ *
+ * The rectangles live in dim dimensions (two for rectangles, three for
+ * boxes): x[k][i] is the coordinate and w[k][i] the size of rectangle
+ * i along axis k. Along every axis j can be before or after i, and the
+ * rule for a pair is: if j cannot be on any side of i except one, then
+ * it must be on that one.
+ *
+ * The sizes are views of type SView: ConstIntView for rectangles with
+ * fixed sizes and IntView for rectangles with variable sizes. Variable
+ * sizes are propagated on their bounds: the rules use the smallest
+ * size of a rectangle, and the largest size is pruned when a rectangle
+ * must be before another one.
+ *
+ * Rectangles can be optional, with a Boolean view o[i] telling whether
+ * rectangle i is placed. Only pairs of placed rectangles are pruned. An
+ * optional rectangle that must overlap a placed one is left out.
+ */
+template<class SView, int dim>
+class NoOverlap : public Propagator {
+protected:
+  // The coordinates along each axis
+  ViewArray<IntView> x[dim];
+  // The sizes along each axis
+  ViewArray<SView> w[dim];
+  // Whether the rectangles are placed (empty if all of them are)
+  ViewArray<BoolView> o;
+  // The filtering algorithm
+  NoOverlapFilter f;
+  // Whether the filtering algorithm uses the sweep
+  bool sweeping(void) const {
+    return (f == NOOVERLAP_SWEEP) || (f == NOOVERLAP_ENERGETIC);
+  }
+  // Whether the filtering algorithm records resolved pairs
+  bool resolving(void) const {
+    return (f == NOOVERLAP_PAIRWISE) || (f == NOOVERLAP_INCREMENTAL);
+  }
+  // Test whether rectangle i is placed
+  bool placed(int i) const {
+    return (o.size() == 0) || o[i].one();
+  }
+  // Test whether rectangle i is left out
+  bool absent(int i) const {
+    return (o.size() != 0) && o[i].zero();
+  }
+  // Rectangles sorted by start of compulsory part along the first two
+  // axes (sweep only)
+  int* so[2];
+
+  // Advisor for a coordinate, size, or presence (incremental only)
+  class Coord : public Advisor {
+  public:
+    // Index of the rectangle
+    int i;
+    // The view: the coordinate along axis v for v < dim, the size along
+    // axis v-dim for v < 2*dim, and the presence otherwise
+    int v;
+    // Create advisor
+    Coord(Space& home, Propagator& p, Council<Coord>& c, int i0, int v0)
+      : Advisor(home,p,c), i(i0), v(v0) {}
+    // Copy advisor during cloning
+    Coord(Space& home, bool share, Coord& a)
+      : Advisor(home,share,a), i(a.i), v(a.v) {}
+  };
+  // The advisors (incremental only)
+  Council<Coord> c;
+  // Modified rectangles since the last run (incremental only)
+  int* ml;
+  // Number of modified rectangles
+  int nm;
+  // Whether a rectangle is in the list of modified rectangles
+  bool* mf;
+
+  /*
+   * Pairs of rectangles that are apart for good (pairwise and
+   * incremental only): the bit i*n+j is set for i<j once i and j can
+   * no longer overlap. The bits only ever get set and are copied when
+   * cloning, so they are always consistent with the space after
+   * backtracking. Resolved pairs are skipped by later runs.
+   */
+  unsigned int* pa;
+  // Number of pairs that are not yet apart for good
+  int np;
+  // Number of bits per word in pa
+  static const int bpw = 8*sizeof(unsigned int);
+  // Number of words in pa
+  int words(void) const {
+    int n=x[0].size();
+    return (n*n + bpw - 1) / bpw;
+  }
+  // Position of pair (i,j) in pa
+  int pair(int i, int j) const {
+    return (i < j) ? i*x[0].size()+j : j*x[0].size()+i;
+  }
+  // Test whether pair (i,j) is known to be apart for good
+  bool resolved(int i, int j) const {
+    int k=pair(i,j);
+    return ((pa[k / bpw] >> (k % bpw)) & 1U) != 0U;
+  }
+  // Record that pair (i,j) is apart for good
+  void resolve(int i, int j) {
+    int k=pair(i,j);
+    pa[k / bpw] |= 1U << (k % bpw);
+    np--;
+  }
+  // Test whether j cannot be before i along axis k
+  bool notbefore(int k, int i, int j) const {
+    return x[k][j].min() + w[k][j].min() > x[k][i].max();
+  }
+  // Test whether i and j are apart for any values of the views
+  bool disjoint(int i, int j) const {
+    for (int k=0; k<dim; k++)
+      if ((x[k][j].min() >= x[k][i].max()+w[k][i].max()) || // j after i
+          (x[k][i].min() >= x[k][j].max()+w[k][j].max()))   // j before i
+        return true;
+    return false;
+  }
+  // Test whether i and j overlap for all values of the views
+  bool overlapping(int i, int j) const {
+    for (int k=0; k<dim; k++)
+      if (!notbefore(k,i,j) || !notbefore(k,j,i))
+        return false;
+    return true;
+  }
+
+  // Test whether the view of advisor a is assigned
+  bool assigned(const Coord& a) const {
+    if (a.v < dim)
+      return x[a.v][a.i].assigned();
+    if (a.v < 2*dim)
+      return w[a.v-dim][a.i].assigned();
+    return o[a.i].assigned();
+  }
+  // Cancel the subscription of advisor a
+  void cancel(Space& home, Coord& a) {
+    if (a.v < dim)
+      x[a.v][a.i].cancel(home,a);
+    else if (a.v < 2*dim)
+      w[a.v-dim][a.i].cancel(home,a);
+    else
+      o[a.i].cancel(home,a);
+  }
+
+  // Record that rectangle i has been modified
+  void modified(int i) {
+    if (!mf[i]) {
+      mf[i]=true; ml[nm++]=i;
+    }
+  }
+
+  // Order rectangles by start of their compulsory part along an axis
+  class StartLess {
+  protected:
+    const ViewArray<IntView>& u;
+  public:
+    StartLess(const ViewArray<IntView>& u0) : u(u0) {}
+    bool operator ()(int i, int j) const {
+      return u[i].max() < u[j].max();
+    }
+  };
+
+  /*
+   * Handle a pair where at most one rectangle is placed: an optional
+   * rectangle that must overlap a placed one is left out. Nothing can
+   * be said about two optional rectangles, as only one of them might
+   * be placed.
+   */
+  ExecStatus optional(Space& home, int i, int j, bool& mod) {
+    if (absent(i) || absent(j) || !overlapping(i,j))
+      return ES_OK;
+    if (placed(i))
+      GECODE_ME_CHECK_MODIFIED(mod, o[j].zero(home));
+    else if (placed(j))
+      GECODE_ME_CHECK_MODIFIED(mod, o[i].zero(home));
+    return ES_OK;
+  }
+
+  /*
+   * Apply the rule to rectangles i and j. If the only side left is j
+   * after i along axis k, then j must start after the earliest end of
+   * i and the size of i is bounded by the latest start of j (and the
+   * other way round if j is before i).
+   */
+  ExecStatus rules(Space& home, int i, int j, bool& mod) {
+    if (!placed(i) || !placed(j))
+      return optional(home,i,j,mod);
+    // The only side left: a must be before b along axis k
+    int sides=0, k=0, a=i, b=j;
+    for (int l=0; l<dim; l++) {
+      if (!notbefore(l,j,i)) { // j can be after i
+        sides++; k=l; a=i; b=j;
+      }
+      if (!notbefore(l,i,j)) { // j can be before i
+        sides++; k=l; a=j; b=i;
+      }
+      if (sides > 1)
+        return ES_OK;
+    }
+    // No side is left, the rectangles must overlap
+    if (sides == 0)
+      return ES_FAILED;
+    GECODE_ME_CHECK_MODIFIED(mod,
+      x[k][b].gq(home, x[k][a].min()+w[k][a].min()));
+    GECODE_ME_CHECK_MODIFIED(mod,
+      w[k][a].lq(home, x[k][b].max()-x[k][a].min()));
+    return ES_OK;
+  }
+
+  // Apply the rules to a pair that is not yet resolved
+  ExecStatus check(Space& home, int i, int j, bool& mod) {
+    if (resolved(i,j))
+      return ES_OK;
+    GECODE_ES_CHECK(rules(home,i,j,mod));
+    // A rectangle that is left out can overlap any other one
+    if (disjoint(i,j) || absent(i) || absent(j))
+      resolve(i,j);
+    return ES_OK;
+  }
+
+  /*
+   * Sweep along axis k and apply the rules to the pairs that are forced
+   * to overlap along k.
+   *
+   * With l(i)=x[k][i].max() and r(i)=x[k][i].min()+w[k][i].min(), two
+   * rectangles i and j are forced to overlap along k if and only if
+   *   l(i) < r(j) and l(j) < r(i),
+   * that is, if the intervals [l,r) of i and j intersect (for a
+   * rectangle with a compulsory part along k this interval is exactly
+   * the compulsory part). Only pairs that are forced to overlap along
+   * all axes but one can be pruned, so sweeping along the first two
+   * axes finds all of them.
+   *
+   * With the rectangles sorted by l (the event where the interval
+   * starts), the rectangles that can be forced to overlap with i and
+   * come after i in the order form a contiguous block which ends at the
+   * first rectangle starting at or after r(i) (the event where the
+   * interval of i ends). The order is kept between runs and sorted
+   * again by insertion, which takes O(n + d) for d rectangles out of
+   * order. One run costs O(n + d + k), where k is the number of
+   * inspected pairs. Both d and k are quadratic in the worst case, but
+   * the order changes little between runs and k is small unless many
+   * rectangles have compulsory parts that overlap.
+   */
+  ExecStatus sweep(Space& home, int k, bool& mod) {
+    ViewArray<IntView>& u=x[k];
+    ViewArray<SView>& su=w[k];
+    int* s=so[k];
+    int n=u.size();
+    StartLess lt(u);
+    Support::insertion(s,n,lt);
+    for (int a=0; a<n-1; a++) {
+      int i=s[a];
+      int ei=u[i].min()+su[i].min(); // end of the interval of i
+      for (int b=a+1; (b<n) && (u[s[b]].max() < ei); b++) {
+        int j=s[b];
+        // i and j overlap along k, so they must be apart along another
+        if (u[i].max() < u[j].min()+su[j].min())
+          GECODE_ES_CHECK(rules(home,i,j,mod));
+      }
+    }
+    return ES_OK;
+  }
+
+  // Minimal length of [t,t+s) inside [a,b) for umin <= t <= umax
+  static int overlap(int umin, int umax, int s, int a, int b) {
+    return std::max(0, std::min(std::min(s, b-a),
+                                std::min(umin+s-a, b-umax)));
+  }
+  // Length of [t,t+s) inside [a,b)
+  static int overlap(int t, int s, int a, int b) {
+    return std::max(0, std::min(t+s, b) - std::max(t, a));
+  }
+  // Minimal volume of rectangle i inside [c,d) along all axes but k
+  long long int across(int i, int k, const int c[], const int d[]) const {
+    long long int v=1;
+    for (int l=0; l<dim; l++)
+      if (l != k)
+        v *= overlap(x[l][i].min(),x[l][i].max(),w[l][i].min(),c[l],d[l]);
+    return v;
+  }
+
+  /*
+   * Energetic reasoning on strips along axis k.
+   *
+   * A strip is the window [a,b) along k times the extent [c,d) of all
+   * rectangles along the other axes. Every rectangle requires at least
+   * its minimal overlap with the window along k times its minimal
+   * volume inside [c,d) along the other axes of the volume of the
+   * window. If the required volume exceeds the window the propagator
+   * fails. Otherwise every rectangle may only use the volume left by
+   * the others, which bounds how far it can reach into the window and
+   * prunes its coordinate along k.
+   *
+   * The windows start at some x.min() and end at some x.max()+w, so
+   * a run costs O(n^3). Only placed rectangles take part.
+   */
+  ExecStatus energetic(Space& home, int k, bool& mod) {
+    ViewArray<IntView>& u=x[k];
+    ViewArray<SView>& su=w[k];
+    int n=u.size();
+    // Extent of all placed rectangles along the other axes
+    int c[dim], d[dim];
+    for (int l=0; l<dim; l++) {
+      c[l]=Int::Limits::max; d[l]=Int::Limits::min;
+    }
+    for (int i=0; i<n; i++)
+      if (placed(i))
+        for (int l=0; l<dim; l++) {
+          c[l]=std::min(c[l],x[l][i].min());
+          d[l]=std::max(d[l],x[l][i].max()+w[l][i].min());
+        }
+    if (c[k] > d[k])
+      return ES_OK;
+    long long int e=1;
+    for (int l=0; l<dim; l++)
+      if (l != k)
+        e *= d[l]-c[l];
+    for (int p=0; p<n; p++)
+      for (int q=0; q<n; q++) {
+        int a=u[p].min(), b=u[q].max()+su[q].min();
+        if (!placed(p) || !placed(q) || (a >= b))
+          continue;
+        // Volume available in and required by the window
+        long long int avail=(b-a)*e;
+        long long int req=0;
+        for (int i=0; i<n; i++)
+          if (placed(i))
+            req += (overlap(u[i].min(),u[i].max(),su[i].min(),a,b) *
+                    across(i,k,c,d));
+        if (req > avail)
+          return ES_FAILED;
+        for (int i=0; i<n; i++) {
+          if (!placed(i))
+            continue;
+          long long int mv=across(i,k,c,d);
+          if (mv == 0)
+            continue;
+          int mu=overlap(u[i].min(),u[i].max(),su[i].min(),a,b);
+          // Longest overlap of i with [a,b) along k that still fits
+          long long int lu=(avail - req + mu*mv) / mv;
+          int si=su[i].min();
+          if (overlap(u[i].min(),si,a,b) > lu) // too much on the left
+            GECODE_ME_CHECK_MODIFIED(mod,
+              u[i].gq(home, b-static_cast<int>(lu)));
+          if (overlap(u[i].max(),si,a,b) > lu) // too much on the right
+            GECODE_ME_CHECK_MODIFIED(mod,
+              u[i].lq(home, a+static_cast<int>(lu)-si));
+        }
+      }
+    return ES_OK;
+  }
+
+  // Check all pairs of rectangles
+  ExecStatus pairwise(Space& home, bool& mod) {
+    int n=x[0].size();
+    for (int i=0; i<n-1; i++)
+      for (int j=i+1; j<n; j++)
+        GECODE_ES_CHECK(check(home,i,j,mod));
+    return ES_OK;
+  }
+
+  /*
+   * Bounds of the coordinates and sizes of all rectangles along each
+   * axis in contiguous arrays (SIMD only). The arrays have room for one
+   * more full vector after the last rectangle, so vectors can be loaded
+   * from any position.
+   */
+  class Snapshot {
+  public:
+    int *xl[dim], *xu[dim], *wl[dim], *wu[dim];
+    // Allocate for n rectangles
+    Snapshot(Region& r, int n) {
+      int m=n+8;
+      for (int k=0; k<dim; k++) {
+        xl[k]=r.alloc<int>(m); xu[k]=r.alloc<int>(m);
+        wl[k]=r.alloc<int>(m); wu[k]=r.alloc<int>(m);
+        for (int i=n; i<m; i++)
+          xl[k][i]=xu[k][i]=wl[k][i]=wu[k][i]=0;
+      }
+    }
+  };
+  // Store the bounds of rectangle i in the snapshot
+  void load(Snapshot& s, int i) const {
+    for (int k=0; k<dim; k++) {
+      s.xl[k][i]=x[k][i].min(); s.xu[k][i]=x[k][i].max();
+      s.wl[k][i]=w[k][i].min(); s.wu[k][i]=w[k][i].max();
+    }
+  }
+
+#ifdef NOOVERLAP_AVX2
+  // Load eight values from a
+  NOOVERLAP_AVX2
+  static __m256i load8(const int* a) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a));
+  }
+  // Compare eight values
+  NOOVERLAP_AVX2
+  static __m256i gr(__m256i a, __m256i b) {
+    return _mm256_cmpgt_epi32(a,b);
+  }
+  // Conjunction and disjunction of eight values
+  NOOVERLAP_AVX2
+  static __m256i conj(__m256i a, __m256i b) {
+    return _mm256_and_si256(a,b);
+  }
+  NOOVERLAP_AVX2
+  static __m256i disj(__m256i a, __m256i b) {
+    return _mm256_or_si256(a,b);
+  }
+#endif
+
+  /*
+   * Return the rectangles j0 <= j < j0+8 for which a rule prunes the
+   * pair (i,j) on the snapshot, one bit per rectangle. A rule only
+   * counts if its conclusion does not hold yet, so pairs at fixpoint
+   * are not reported. This is the reference for the vector kernel.
+   */
+  static unsigned int candidates(const Snapshot& s, int i, int j0) {
+    unsigned int c=0U;
+    for (int q=0; q<8; q++) {
+      int j=j0+q;
+      bool nb[dim], na[dim], pb[dim], pa[dim];
+      for (int k=0; k<dim; k++) {
+        nb[k]=s.xl[k][j]+s.wl[k][j] > s.xu[k][i];
+        na[k]=s.xl[k][i]+s.wl[k][i] > s.xu[k][j];
+        pb[k]=(s.xl[k][j]+s.wl[k][j] > s.xl[k][i]) ||
+              (s.xl[k][j]+s.wu[k][j] > s.xu[k][i]);
+        pa[k]=(s.xl[k][i]+s.wl[k][i] > s.xl[k][j]) ||
+              (s.xl[k][i]+s.wu[k][i] > s.xu[k][j]);
+      }
+      for (int k=0; k<dim; k++) {
+        bool r=true;
+        for (int l=0; l<dim; l++)
+          if (l != k)
+            r = r && nb[l] && na[l];
+        if (r && ((nb[k] && pa[k]) || (na[k] && pb[k])))
+          c |= 1U << q;
+      }
+    }
+    return c;
+  }
+
+#ifdef NOOVERLAP_AVX2
+  // Same as candidates, eight rectangles at a time with AVX2
+  NOOVERLAP_AVX2
+  static unsigned int candidates8(const Snapshot& s, int i, int j0) {
+    // Per axis: j cannot be before or after i, and j before or after i
+    // is not yet established
+    __m256i nb[dim], na[dim], pb[dim], pa[dim];
+    for (int k=0; k<dim; k++) {
+      __m256i xl=load8(s.xl[k]+j0), xu=load8(s.xu[k]+j0);
+      __m256i wl=load8(s.wl[k]+j0), wu=load8(s.wu[k]+j0);
+      __m256i xli=_mm256_set1_epi32(s.xl[k][i]);
+      __m256i xui=_mm256_set1_epi32(s.xu[k][i]);
+      // Earliest ends of j and of i
+      __m256i xe=_mm256_add_epi32(xl,wl);
+      __m256i xei=_mm256_set1_epi32(s.xl[k][i]+s.wl[k][i]);
+      nb[k]=gr(xe,xui); na[k]=gr(xei,xu);
+      pb[k]=disj(gr(xe,xli), gr(_mm256_add_epi32(xl,wu),xui));
+      pa[k]=disj(gr(xei,xl),
+                 gr(_mm256_set1_epi32(s.xl[k][i]+s.wu[k][i]),xu));
+    }
+    __m256i m=_mm256_setzero_si256();
+    for (int k=0; k<dim; k++) {
+      // Neither side is left along the other axes
+      __m256i r=_mm256_set1_epi32(-1);
+      for (int l=0; l<dim; l++)
+        if (l != k)
+          r=conj(r,conj(nb[l],na[l]));
+      m=disj(m,conj(r,disj(conj(nb[k],pa[k]),conj(na[k],pb[k]))));
+    }
+    return static_cast<unsigned int>
+      (_mm256_movemask_ps(_mm256_castsi256_ps(m)));
+  }
+#endif
+
+  /*
+   * Check all pairs of rectangles on a snapshot of the bounds, eight
+   * pairs at a time. Only the pairs reported by the vector test are
+   * handed to the rules, after which the snapshot of both rectangles
+   * is refreshed. Without AVX2 this checks all pairs directly, as one
+   * lane at a time is slower than that.
+   */
+  ExecStatus simd(Space& home, bool& mod) {
+#ifdef NOOVERLAP_AVX2
+    if (!nooverlapavx2())
+      return pairwise(home,mod);
+    int n=x[0].size();
+    Region r(home);
+    Snapshot s(r,n);
+    for (int i=0; i<n; i++)
+      load(s,i);
+    for (int i=0; i<n-1; i++)
+      for (int j0=i+1; j0<n; j0+=8) {
+        unsigned int c=candidates8(s,i,j0);
+        // Mask out the lanes after the last rectangle
+        if (n-j0 < 8)
+          c &= (1U << (n-j0)) - 1U;
+        for (int k=0; c != 0U; k++, c >>= 1)
+          if (c & 1U) {
+            GECODE_ES_CHECK(rules(home,i,j0+k,mod));
+            load(s,i); load(s,j0+k);
+          }
+      }
+    return ES_OK;
+#else
+    return pairwise(home,mod);
+#endif
+  }
+
+  /*
+   * Check only the pairs involving a rectangle that has been modified
+   * since the last run. Pairs of unmodified rectangles are still at
+   * fixpoint from the last run. Rectangles modified by the rules are
+   * recorded again by their advisors, so the loop ends at fixpoint.
+   */
+  ExecStatus incremental(Space& home) {
+    int n=x[0].size();
+    bool mod=false;
+    while (nm > 0) {
+      int i=ml[--nm];
+      mf[i]=false;
+      for (int j=0; j<n; j++)
+        if (j != i)
+          GECODE_ES_CHECK(check(home,i,j,mod));
+    }
+    return ES_OK;
+  }
+
+public:
+  // Create propagator and initialize
+  NoOverlap(Home home,
+            ViewArray<IntView> x0[], ViewArray<SView> w0[],
+            ViewArray<BoolView>& o0, NoOverlapFilter f0)
+      : Propagator(home), o(o0), f(f0), c(home),
+        ml(NULL), nm(0), mf(NULL), pa(NULL), np(0) {
+    for (int k=0; k<dim; k++) {
+      x[k]=x0[k]; w[k]=w0[k];
+    }
+    so[0]=so[1]=NULL;
+    int n=x[0].size();
+    if (resolving()) {
+      // No pair is resolved yet
+      np = n*(n-1)/2;
+      pa = static_cast<Space&>(home).alloc<unsigned int>(words());
+      for (int k=words(); k--; )
+        pa[k]=0U;
+    }
+    if (sweeping()) {
+      for (int k=0; k<2; k++) {
+        so[k] = static_cast<Space&>(home).alloc<int>(n);
+        for (int i=n; i--; )
+          so[k][i]=i;
+      }
+    }
+    if (f == NOOVERLAP_INCREMENTAL) {
+      // Every rectangle counts as modified for the first run
+      ml = static_cast<Space&>(home).alloc<int>(n);
+      mf = static_cast<Space&>(home).alloc<bool>(n);
+      for (int i=n; i--; ) {
+        mf[i]=true; ml[nm++]=i;
+      }
+      for (int i=n; i--; ) {
+        for (int k=0; k<dim; k++) {
+          x[k][i].subscribe(home,*new (home) Coord(home,*this,c,i,k));
+          // Fixed sizes need no advisor
+          if (!w[k][i].assigned())
+            w[k][i].subscribe(home,
+                              *new (home) Coord(home,*this,c,i,dim+k));
+        }
+        if ((o.size() != 0) && !o[i].assigned())
+          o[i].subscribe(home,*new (home) Coord(home,*this,c,i,2*dim));
+      }
+      // Advisors do not schedule the propagator, so do it here
+      IntView::schedule(home,*this,ME_INT_BND);
+    } else {
+      for (int k=0; k<dim; k++) {
+        x[k].subscribe(home,*this,PC_INT_BND);
+        w[k].subscribe(home,*this,PC_INT_BND);
+      }
+      o.subscribe(home,*this,PC_BOOL_VAL);
+    }
+  }
+  // Post no-overlap propagator
+  static ExecStatus post(Home home,
+                         ViewArray<IntView> x[], ViewArray<SView> w[],
+                         ViewArray<BoolView>& o, NoOverlapFilter f) {
+    // Sizes cannot be negative
+    for (int k=0; k<dim; k++)
+      for (int i=w[k].size(); i--; )
+        GECODE_ME_CHECK(w[k][i].gq(home,0));
+    // Only if there is something to propagate
+    if (x[0].size() > 1)
+      (void) new (home) NoOverlap(home,x,w,o,f);
+    return ES_OK;
+  }
+
+  // Copy constructor during cloning
+  NoOverlap(Space& home, bool share, NoOverlap& p)
+      : Propagator(home,share,p), f(p.f),
+        ml(NULL), nm(p.nm), mf(NULL), pa(NULL), np(p.np) {
+    for (int k=0; k<dim; k++) {
+      x[k].update(home,share,p.x[k]);
+      w[k].update(home,share,p.w[k]);
+    }
+    o.update(home,share,p.o);
+    int n=x[0].size();
+    so[0]=so[1]=NULL;
+    // Keep the sweep orders, they are almost sorted
+    if (sweeping()) {
+      for (int k=0; k<2; k++) {
+        so[k] = home.alloc<int>(n);
+        for (int i=n; i--; )
+          so[k][i]=p.so[k][i];
+      }
+    }
+    if (resolving()) {
+      pa = home.alloc<unsigned int>(words());
+      for (int k=words(); k--; )
+        pa[k]=p.pa[k];
+    }
+    if (f == NOOVERLAP_INCREMENTAL) {
+      c.update(home,share,p.c);
+      ml = home.alloc<int>(n);
+      mf = home.alloc<bool>(n);
+      for (int i=n; i--; )
+        mf[i]=p.mf[i];
+      for (int i=nm; i--; )
+        ml[i]=p.ml[i];
+    }
+  }
+  // Create copy during cloning
+  virtual Propagator* copy(Space& home, bool share) {
+    return new (home) NoOverlap(home,share,*this);
+  }
+
+  // Return cost (cheap quadratic, or linear when sweeping or when
+  // only few rectangles have been modified)
+  virtual PropCost cost(const Space&, const ModEventDelta&) const {
+    int n=x[0].size();
+    if (f == NOOVERLAP_ENERGETIC)
+      return PropCost::cubic(PropCost::LO, dim*n);
+    if (sweeping() || (f == NOOVERLAP_INCREMENTAL))
+      return PropCost::linear(PropCost::HI, dim*n);
+    if ((f == NOOVERLAP_SIMD) && nooverlapavx2())
+      return PropCost::linear(PropCost::HI, n*n/8);
+    return PropCost::quadratic(PropCost::LO, dim*n);
+  }
+
+  // Record the rectangle whose coordinate, size, or presence has been
+  // modified
+  virtual ExecStatus advise(Space& home, Advisor& a0, const Delta&) {
+    Coord& a = static_cast<Coord&>(a0);
+    modified(a.i);
+    // An assigned view will not be modified again
+    if (assigned(a))
+      return home.ES_NOFIX_DISPOSE(c,a);
+    return ES_NOFIX;
+  }
+
+  /*
+   * Perform propagation
+   *
+   * A pass over the rectangles can enable rules for pairs that have
+   * already been checked in the same pass. So passes are repeated until
+   * one does not modify anything, and the propagator then reports that
+   * it is at fixpoint. The incremental algorithm reaches its fixpoint
+   * by itself, as it records its own modifications.
+   */
+  virtual ExecStatus propagate(Space& home, const ModEventDelta&) {
+    NoOverlapStatistics::Counts& c = NoOverlapStatistics::local();
+    c.runs++;
+    bool mod;
+    do {
+      c.passes++;
+      mod=false;
+      switch (f) {
+      case NOOVERLAP_SWEEP:
+        GECODE_ES_CHECK(sweep(home,0,mod));
+        GECODE_ES_CHECK(sweep(home,1,mod));
+        break;
+      case NOOVERLAP_ENERGETIC:
+        GECODE_ES_CHECK(sweep(home,0,mod));
+        GECODE_ES_CHECK(sweep(home,1,mod));
+        // Strips along each axis prune that axis
+        for (int k=0; k<dim; k++)
+          GECODE_ES_CHECK(energetic(home,k,mod));
+        break;
+      case NOOVERLAP_INCREMENTAL:
+        GECODE_ES_CHECK(incremental(home));
+        break;
+      case NOOVERLAP_SIMD:
+        GECODE_ES_CHECK(simd(home,mod));
+        break;
+      default:
+        GECODE_ES_CHECK(pairwise(home,mod));
+        break;
+      }
+    } while (mod);
+
+    // Nothing is left to do once all pairs are apart for good
+    if (resolving()) {
+      if (np == 0)
+        return home.ES_SUBSUMED(*this);
+      return ES_FIX;
+    }
+    // Pairs are not recorded, rely on assignment instead
+    for (int k=0; k<dim; k++)
+      if (!x[k].assigned() || !w[k].assigned())
+        return ES_FIX;
+    if (!o.assigned())
+      return ES_FIX;
+    return home.ES_SUBSUMED(*this);
+  }
+
+  // Dispose propagator and return its size
+  virtual size_t dispose(Space& home) {
+    if (f == NOOVERLAP_INCREMENTAL) {
+      for (Advisors<Coord> as(c); as(); ++as)
+        cancel(home,as.advisor());
+      c.dispose(home);
+    } else {
+      for (int k=0; k<dim; k++) {
+        x[k].cancel(home,*this,PC_INT_BND);
+        w[k].cancel(home,*this,PC_INT_BND);
+      }
+      o.cancel(home,*this,PC_BOOL_VAL);
+    }
+    (void) Propagator::dispose(home);
+    return sizeof(*this);
+  }
+}; // end of class NoOverlap
+
+// Return an array of constant views for the fixed sizes s
+ViewArray<ConstIntView> constviews(Home home, const IntArgs& s) {
+  ViewArray<ConstIntView> v(home,s.size());
+  for (int i=s.size(); i--; )
+    v[i]=ConstIntView(s[i]);
+  return v;
+}
+
+/*
+ * Post the constraint that the rectangles defined by the coordinates
+ * x and y and width w and height h do not overlap.
+ *
+ * The filtering algorithm f selects how the pairs of rectangles are
+ * inspected (see NoOverlapFilter).
+ */
+void nooverlap2(Home home,
+               const IntVarArgs& x, const IntArgs& w,
+               const IntVarArgs& y, const IntArgs& h,
+               NoOverlapFilter f=NOOVERLAP_SWEEP) {
+  // Check whether the arguments make sense
+  if ((x.size() != y.size()) || (x.size() != w.size()) ||
+      (y.size() != h.size()))
+    throw ArgumentSizeMismatch("nooverlap");
+  // Never post a propagator in a failed space
+  if (home.failed()) return;
+  // Set up arrays of views for the coordinates
+  ViewArray<IntView> vx[2];
+  vx[0]=ViewArray<IntView>(home,x); vx[1]=ViewArray<IntView>(home,y);
+  // Set up arrays of constant views for width and height
+  ViewArray<ConstIntView> vw[2];
+  vw[0]=constviews(home,w); vw[1]=constviews(home,h);
+  // All rectangles are placed
+  ViewArray<BoolView> vo;
+  // If posting failed, fail space
+  if (NoOverlap<ConstIntView,2>::post(home,vx,vw,vo,f) != ES_OK)
+    home.fail();
+}
+
+/*
+ * Post the constraint that the rectangles defined by the coordinates
+ * x and y and the variable width w and height h do not overlap.
+ *
+ * The sizes are pruned on their bounds as well as the coordinates.
+ */
+void nooverlap2(Home home,
+               const IntVarArgs& x, const IntVarArgs& w,
+               const IntVarArgs& y, const IntVarArgs& h,
+               NoOverlapFilter f=NOOVERLAP_SWEEP) {
+  // Check whether the arguments make sense
+  if ((x.size() != y.size()) || (x.size() != w.size()) ||
+      (y.size() != h.size()))
+    throw ArgumentSizeMismatch("nooverlap");
+  // Never post a propagator in a failed space
+  if (home.failed()) return;
+  // Set up arrays of views for the coordinates and sizes
+  ViewArray<IntView> vx[2];
+  vx[0]=ViewArray<IntView>(home,x); vx[1]=ViewArray<IntView>(home,y);
+  ViewArray<IntView> vw[2];
+  vw[0]=ViewArray<IntView>(home,w); vw[1]=ViewArray<IntView>(home,h);
+  // All rectangles are placed
+  ViewArray<BoolView> vo;
+  // If posting failed, fail space
+  if (NoOverlap<IntView,2>::post(home,vx,vw,vo,f) != ES_OK)
+    home.fail();
+}
+
+/*
+ * Post the constraint that the rectangles defined by the coordinates
+ * x and y and width w and height h do not overlap, where rectangle i
+ * is only placed if o[i] is true.
+ *
+ * Rectangles that are not placed are ignored, and a rectangle that
+ * cannot be placed next to the placed ones is left out.
+ */
+void nooverlap2(Home home,
+               const IntVarArgs& x, const IntArgs& w,
+               const IntVarArgs& y, const IntArgs& h,
+               const BoolVarArgs& o,
+               NoOverlapFilter f=NOOVERLAP_SWEEP) {
+  // Check whether the arguments make sense
+  if ((x.size() != y.size()) || (x.size() != w.size()) ||
+      (y.size() != h.size()) || (x.size() != o.size()))
+    throw ArgumentSizeMismatch("nooverlap");
+  // Never post a propagator in a failed space
+  if (home.failed()) return;
+  // Set up arrays of views for the coordinates and presence
+  ViewArray<IntView> vx[2];
+  vx[0]=ViewArray<IntView>(home,x); vx[1]=ViewArray<IntView>(home,y);
+  ViewArray<BoolView> vo(home,o);
+  // Set up arrays of constant views for width and height
+  ViewArray<ConstIntView> vw[2];
+  vw[0]=constviews(home,w); vw[1]=constviews(home,h);
+  // If posting failed, fail space
+  if (NoOverlap<ConstIntView,2>::post(home,vx,vw,vo,f) != ES_OK)
+    home.fail();
+}
+
+/*
+ * Post the constraint that the rectangles defined by the coordinates
+ * x and y and the variable width w and height h do not overlap, where
+ * rectangle i is only placed if o[i] is true.
+ */
+void nooverlap2(Home home,
+               const IntVarArgs& x, const IntVarArgs& w,
+               const IntVarArgs& y, const IntVarArgs& h,
+               const BoolVarArgs& o,
+               NoOverlapFilter f=NOOVERLAP_SWEEP) {
+  // Check whether the arguments make sense
+  if ((x.size() != y.size()) || (x.size() != w.size()) ||
+      (y.size() != h.size()) || (x.size() != o.size()))
+    throw ArgumentSizeMismatch("nooverlap");
+  // Never post a propagator in a failed space
+  if (home.failed()) return;
+  // Set up arrays of views for the coordinates, sizes, and presence
+  ViewArray<IntView> vx[2];
+  vx[0]=ViewArray<IntView>(home,x); vx[1]=ViewArray<IntView>(home,y);
+  ViewArray<IntView> vw[2];
+  vw[0]=ViewArray<IntView>(home,w); vw[1]=ViewArray<IntView>(home,h);
+  ViewArray<BoolView> vo(home,o);
+  // If posting failed, fail space
+  if (NoOverlap<IntView,2>::post(home,vx,vw,vo,f) != ES_OK)
+    home.fail();
+}
+
+/*
+ * Post the constraint that the boxes defined by the coordinates x, y,
+ * and z and width w, height h, and depth d do not overlap.
+ */
+void nooverlap3(Home home,
+               const IntVarArgs& x, const IntArgs& w,
+               const IntVarArgs& y, const IntArgs& h,
+               const IntVarArgs& z, const IntArgs& d,
+               NoOverlapFilter f=NOOVERLAP_SWEEP) {
+  // Check whether the arguments make sense
+  if ((x.size() != y.size()) || (x.size() != z.size()) ||
+      (x.size() != w.size()) || (y.size() != h.size()) ||
+      (z.size() != d.size()))
+    throw ArgumentSizeMismatch("nooverlap");
+  // Never post a propagator in a failed space
+  if (home.failed()) return;
+  // Set up arrays of views for the coordinates
+  ViewArray<IntView> vx[3];
+  vx[0]=ViewArray<IntView>(home,x); vx[1]=ViewArray<IntView>(home,y);
+  vx[2]=ViewArray<IntView>(home,z);
+  // Set up arrays of constant views for width, height, and depth
+  ViewArray<ConstIntView> vw[3];
+  vw[0]=constviews(home,w); vw[1]=constviews(home,h);
+  vw[2]=constviews(home,d);
+  // All boxes are placed
+  ViewArray<BoolView> vo;
+  // If posting failed, fail space
+  if (NoOverlap<ConstIntView,3>::post(home,vx,vw,vo,f) != ES_OK)
+    home.fail();
+}
+
+/*
+ * Post the constraint that the boxes defined by the coordinates x, y,
+ * and z and width w, height h, and depth d do not overlap, where box i
+ * is only placed if o[i] is true.
+ */
+void nooverlap3(Home home,
+               const IntVarArgs& x, const IntArgs& w,
+               const IntVarArgs& y, const IntArgs& h,
+               const IntVarArgs& z, const IntArgs& d,
+               const BoolVarArgs& o,
+               NoOverlapFilter f=NOOVERLAP_SWEEP) {
+  // Check whether the arguments make sense
+  if ((x.size() != y.size()) || (x.size() != z.size()) ||
+      (x.size() != w.size()) || (y.size() != h.size()) ||
+      (z.size() != d.size()) || (x.size() != o.size()))
+    throw ArgumentSizeMismatch("nooverlap");
+  // Never post a propagator in a failed space
+  if (home.failed()) return;
+  // Set up arrays of views for the coordinates and presence
+  ViewArray<IntView> vx[3];
+  vx[0]=ViewArray<IntView>(home,x); vx[1]=ViewArray<IntView>(home,y);
+  vx[2]=ViewArray<IntView>(home,z);
+  ViewArray<BoolView> vo(home,o);
+  // Set up arrays of constant views for width, height, and depth
+  ViewArray<ConstIntView> vw[3];
+  vw[0]=constviews(home,w); vw[1]=constviews(home,h);
+  vw[2]=constviews(home,d);
+  // If posting failed, fail space
+  if (NoOverlap<ConstIntView,3>::post(home,vx,vw,vo,f) != ES_OK)
+    home.fail();
+}
@@ -0,0 +1,162 @@
+/*
+ *  Main author:
+ *     Yumen & Marion
+ *
+ *  Copyright:
+ *     Yumen & Marion, 2026
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining
+ *  a copy of this software and associated documentation files (the
+ *  "Software"), to deal in the Software without restriction, including
+ *  without limitation the rights to use, copy, modify, merge, publish,
+ *  distribute, sublicense, and/or sell copies of the Software, and to
+ *  permit persons to whom the Software is furnished to do so, subject to
+ *  the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be
+ *  included in all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ *  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ *  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ *  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/*
+ * Results of the square packing on disk
+ *
+ * Every line of the file holds the size n of the biggest square, a
+ * lower and an upper bound on the side of the enclosing box, and
+ * optionally the coordinates x and y of the squares n down to 2 in a
+ * packing with the upper bound as side:
+ *
+ *   n lower upper [x_0 y_0 ... x_{n-2} y_{n-2}]
+ *
+ * The upper bound is 0 if no packing is known. An entry is solved
+ * when both bounds are equal and the packing is known. Lines starting
+ * with '#' are ignored.
+ */
+class ResultCache {
+public:
+  // Bounds and packing for one size
+  class Entry {
+  public:
+    int lower, upper;
+    std::vector<int> x, y;
+    Entry(void) : lower(0), upper(0) {}
+    // Whether a packing with side upper is known
+    bool packed(void) const {
+      return !x.empty();
+    }
+  };
+protected:
+  // File name (no cache if NULL)
+  const char* file;
+  // Entries by size
+  std::map<int,Entry> entries;
+public:
+  // Read the cache from file f (none if NULL or not readable)
+  ResultCache(const char* f) : file(f) {
+    if (file == NULL)
+      return;
+    std::ifstream is(file);
+    std::string l;
+    while (std::getline(is, l)) {
+      if (l.empty() || (l[0] == '#'))
+        continue;
+      std::istringstream ls(l);
+      int k; Entry e;
+      if (!(ls >> k >> e.lower >> e.upper) || (k < 2))
+        continue;
+      int cx, cy;
+      while (ls >> cx >> cy) {
+        e.x.push_back(cx); e.y.push_back(cy);
+      }
+      if (static_cast<int>(e.x.size()) != k-1) {
+        e.x.clear(); e.y.clear();
+      }
+      entries[k] = e;
+    }
+  }
+  // Return the entry for size k (NULL if none)
+  const Entry* get(int k) const {
+    std::map<int,Entry>::const_iterator i = entries.find(k);
+    return (i == entries.end()) ? NULL : &i->second;
+  }
+  // Return whether size k is solved
+  bool solved(int k) const {
+    const Entry* e = get(k);
+    return (e != NULL) && e->packed() && (e->lower == e->upper);
+  }
+  /*
+   * Return bounds on the side for size k (0 if none)
+   *
+   * Removing the biggest square from a packing for k gives a packing
+   * for k-1, so the lower bound for k-1 is one for k as well. Adding
+   * square k beside a packing for k-1 with side u gives a packing for
+   * k with side u+k.
+   */
+  void bounds(int k, int& lower, int& upper) const {
+    lower = 0; upper = 0;
+    if (const Entry* e = get(k)) {
+      lower = e->lower;
+      if (e->packed())
+        upper = e->upper;
+    }
+    if (const Entry* e = get(k-1)) {
+      lower = std::max(lower, e->lower);
+      if (e->packed() && ((upper == 0) || (e->upper + k < upper)))
+        upper = e->upper + k;
+    }
+  }
+  /*
+   * Record a result for size k
+   *
+   * The side s is the one of the packing with coordinates x and y (no
+   * packing if s is 0), lower is a proven lower bound. The known
+   * bounds are only ever tightened.
+   */
+  void record(int k, int lower, int s,
+              const std::vector<int>& x, const std::vector<int>& y) {
+    Entry& e = entries[k];
+    e.lower = std::max(e.lower, lower);
+    if ((s > 0) && (!e.packed() || (s < e.upper))) {
+      e.upper = s; e.x = x; e.y = y;
+    }
+  }
+  // Write the cache back to the file
+  bool save(void) const {
+    if (file == NULL)
+      return true;
+    std::ofstream os(file);
+    os << "# n lower upper [x_0 y_0 ... x_{n-2} y_{n-2}]" << std::endl;
+    for (std::map<int,Entry>::const_iterator i = entries.begin();
+         i != entries.end(); ++i) {
+      const Entry& e = i->second;
+      os << i->first << ' ' << e.lower << ' ' << e.upper;
+      for (unsigned int j=0; j<e.x.size(); j++)
+        os << ' ' << e.x[j] << ' ' << e.y[j];
+      os << std::endl;
+    }
+    return static_cast<bool>(os);
+  }
+  // Print the packing for size k as the square script does
+  void print(int k, std::ostream& os) const {
+    const Entry* e = get(k);
+    os << "s = " << e->upper << std::endl << std::endl;
+    for (int i=0; i<k-1; i++)
+      os << k-i << ", x=" << e->x[i] << ", y=" << e->y[i] << std::endl;
+  }
+};
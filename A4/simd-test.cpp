@@ -0,0 +1,113 @@
+/*
+ *  Main author:
+ *     Yumen & Marion
+ *
+ *  Copyright:
+ *     Yumen & Marion, 2026
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining
+ *  a copy of this software and associated documentation files (the
+ *  "Software"), to deal in the Software without restriction, including
+ *  without limitation the rights to use, copy, modify, merge, publish,
+ *  distribute, sublicense, and/or sell copies of the Software, and to
+ *  permit persons to whom the Software is furnished to do so, subject to
+ *  the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be
+ *  included in all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ *  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ *  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ *  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+/*
+ * Agreement of the vector and scalar no-overlap kernels
+ *
+ * Random bounds for the coordinates and sizes of a few rectangles are
+ * stored in a snapshot, and for every rectangle i and every block of
+ * eight rectangles after it the AVX2 kernel must report the same pairs
+ * as the scalar reference, in two and in three dimensions. Without
+ * AVX2 on the processor there is nothing to compare.
+ */
+
+#include <iostream>
+#include <random>
+#include "no-overlap.cpp"
+
+// Access to the kernels of the no-overlap propagator
+template<int dim>
+class Kernel : public NoOverlap<ConstIntView,dim> {
+public:
+  using typename NoOverlap<ConstIntView,dim>::Snapshot;
+  using NoOverlap<ConstIntView,dim>::candidates;
+#ifdef NOOVERLAP_AVX2
+  using NoOverlap<ConstIntView,dim>::candidates8;
+#endif
+};
+
+// Space for allocating snapshots
+class Empty : public Space {
+public:
+  Empty(void) {}
+  Empty(bool share, Empty& e) : Space(share, e) {}
+  virtual Space* copy(bool share) {
+    return new Empty(share, *this);
+  }
+};
+
+// Compare the kernels on random snapshots in dim dimensions
+template<int dim>
+int check(std::mt19937& r) {
+  int errors = 0;
+#ifdef NOOVERLAP_AVX2
+  std::uniform_int_distribution<int> v(0, 30);
+  Empty home;
+  for (int t=0; t<1000; t++) {
+    Region re(home);
+    int n = 2 + t % 20;
+    typename Kernel<dim>::Snapshot s(re, n);
+    for (int k=0; k<dim; k++)
+      for (int i=0; i<n; i++) {
+        int a = v(r), b = v(r), c = v(r) / 3, d = v(r) / 3;
+        s.xl[k][i] = std::min(a,b); s.xu[k][i] = std::max(a,b);
+        s.wl[k][i] = 1 + std::min(c,d); s.wu[k][i] = 1 + std::max(c,d);
+      }
+    for (int i=0; i<n-1; i++)
+      for (int j0=i+1; j0<n; j0+=8) {
+        unsigned int m = (n-j0 < 8) ? (1U << (n-j0)) - 1U : 0xffU;
+        unsigned int c = Kernel<dim>::candidates(s, i, j0) & m;
+        unsigned int c8 = Kernel<dim>::candidates8(s, i, j0) & m;
+        if (c != c8) {
+          std::cerr << dim << "d: candidates of " << i << " from " << j0
+                    << " differ (" << c << " and " << c8 << ")"
+                    << std::endl;
+          errors++;
+        }
+      }
+  }
+#else
+  (void) r;
+#endif
+  return errors;
+}
+
+int main(void) {
+  if (!nooverlapavx2()) {
+    std::cout << "No AVX2, nothing to compare" << std::endl;
+    return 0;
+  }
+  std::mt19937 r(1);
+  int errors = check<2>(r) + check<3>(r);
+  if (errors > 0) {
+    std::cerr << errors << " errors" << std::endl;
+    return 1;
+  }
+  std::cout << "AVX2 and scalar candidates agree" << std::endl;
+  return 0;
+}
@@ -26,7 +26,18 @@
  */
 
 #include <gecode/driver.hh>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
 #include "interval.cpp"
+#include "no-overlap.cpp"
+#include "cumulative.cpp"
+#include "bottom-left.cpp"
+#include "result-cache.cpp"
 
 using namespace Gecode;
 using namespace Gecode::Int;
@@ -35,153 +46,150 @@ namespace {
   int n = 0; // size of the biggest square
 }
 
-// The no-overlap propagator
-class NoOverlap : public Propagator {
-protected:
-  // The x-coordinates
-  ViewArray<IntView> x;
-  // The width (array)
-  int* w;
-  // The y-coordinates
-  ViewArray<IntView> y;
-  // The heights (array)
-  int* h;
+// How to search for the smallest side of the enclosing box
+enum {
+  SIDES_BAB,   ///< Branch-and-bound over all sides
+  SIDES_UP,    ///< One search per side, increasing from the lower bound
+  SIDES_BISECT ///< One search per side, bisecting up to an upper bound
+};
+
+// Neighbourhoods for large neighbourhood search
+enum {
+  LNS_NONE,   ///< No large neighbourhood search
+  LNS_RANDOM, ///< Free randomly chosen squares
+  LNS_WINDOW  ///< Free the squares overlapping a random window
+};
 
+// Options for the square packing
+class SquareOptions : public SizeOptions {
+protected:
+  // Whether the interval branchings adapt their percentage
+  Driver::BoolOption _adaptive;
+  // Variable selection for the interval branchings
+  Driver::StringOption _select;
+  // Whether the reported packing must not depend on thread timing
+  Driver::BoolOption _deterministic;
+  // Whether to run several branchings concurrently
+  Driver::BoolOption _portfolio;
+  // How to search for the smallest side
+  Driver::StringOption _sides;
+  // Known lower bound for the side (0 if none)
+  Driver::UnsignedIntOption _lower;
+  // Known upper bound for the side (0 if none)
+  Driver::UnsignedIntOption _upper;
+  // File with the results of earlier runs (none if NULL)
+  Driver::StringValueOption _cache;
+  // Neighbourhood for large neighbourhood search
+  Driver::StringOption _lns;
+  // Percentage of the squares freed per neighbourhood
+  Driver::UnsignedIntOption _free;
+  // Number of neighbourhoods to try (0 for no limit)
+  Driver::UnsignedIntOption _restarts;
 public:
-  // Create propagator and initialize
-  NoOverlap(Home home,
-            ViewArray<IntView>& x0, int w0[],
-            ViewArray<IntView>& y0, int h0[])
-      : Propagator(home), x(x0), w(w0), y(y0), h(h0) {
-    x.subscribe(home,*this,PC_INT_BND);
-    y.subscribe(home,*this,PC_INT_BND);
-  }
-  // Post no-overlap propagator
-  static ExecStatus post(Home home,
-                         ViewArray<IntView>& x, int w[],
-                         ViewArray<IntView>& y, int h[]) {
-    // Only if there is something to propagate
-    if (x.size() > 1)
-      (void) new (home) NoOverlap(home,x,w,y,h);
-    return ES_OK;
-  }
-
-  // Copy constructor during cloning
-  NoOverlap(Space& home, bool share, NoOverlap& p)
-      : Propagator(home,share,p) {
-    x.update(home,share,p.x);
-    y.update(home,share,p.y);
-    // Also copy width and height arrays
-    w = home.alloc<int>(x.size());
-    h = home.alloc<int>(y.size());
-    for (int i=x.size(); i--; ) {
-      w[i]=p.w[i]; h[i]=p.h[i];
-    }
+  // Initialize options with name n
+  SquareOptions(const char* n)
+    : SizeOptions(n),
+      _adaptive("-adaptive",
+                "adapt the obligatory part per square in interval branching",
+                false),
+      _select("-select",
+              "variable selection in interval branching",
+              INTERVAL_FIRST),
+      _deterministic("-deterministic",
+                     "report the same packing for any number of threads",
+                     false),
+      _portfolio("-portfolio",
+                 "run all branchings concurrently, first proof wins",
+                 false),
+      _sides("-sides", "how to search for the smallest side", SIDES_BAB),
+      _lower("-lower", "known lower bound for the side (0 for none)", 0),
+      _upper("-upper", "known upper bound for the side (0 for none)", 0),
+      _cache("-cache", "file with the results of earlier runs "
+             "(branch-and-bound then runs as with -deterministic)", NULL),
+      _lns("-lns", "large neighbourhood search", LNS_NONE),
+      _free("-free", "percentage of squares freed per neighbourhood", 30),
+      _restarts("-restarts", "neighbourhoods to try (0 for no limit)",
+                1000) {
+    _lns.add(LNS_NONE, "none", "no large neighbourhood search");
+    _lns.add(LNS_RANDOM, "random", "free randomly chosen squares");
+    _lns.add(LNS_WINDOW, "window",
+             "free the squares overlapping a random window");
+    _sides.add(SIDES_BAB, "bab", "branch-and-bound over the side");
+    _sides.add(SIDES_UP, "up",
+               "one search per side, increasing from the lower bound");
+    _sides.add(SIDES_BISECT, "bisect",
+               "one search per side, bisecting up to the upper bound");
+    _select.add(INTERVAL_FIRST, "first", "first square left to split");
+    _select.add(INTERVAL_WIDTH_MAX, "width", "biggest square");
+    _select.add(INTERVAL_SIZE_MIN, "size", "smallest interval left");
+    _select.add(INTERVAL_AFC_MAX, "afc", "largest accumulated failures");
+    _select.add(INTERVAL_RATIO_MAX, "ratio",
+                "largest area per interval left");
+    add(_adaptive);
+    add(_select);
+    add(_deterministic);
+    add(_portfolio);
+    add(_sides);
+    add(_lower);
+    add(_upper);
+    add(_cache);
+    add(_lns);
+    add(_free);
+    add(_restarts);
   }
-  // Create copy during cloning
-  virtual Propagator* copy(Space& home, bool share) {
-    return new (home) NoOverlap(home,share,*this);
+  // Return whether the interval branchings adapt their percentage
+  bool adaptive(void) const {
+    return _adaptive.value();
   }
-
-  // Return cost (defined as cheap quadratic)
-  virtual PropCost cost(const Space&, const ModEventDelta&) const {
-    return PropCost::quadratic(PropCost::LO, 2*x.size());
+  // Return the variable selection for the interval branchings
+  IntervalSelect select(void) const {
+    return static_cast<IntervalSelect>(_select.value());
   }
-
-  // Perform propagation
-  virtual ExecStatus propagate(Space& home, const ModEventDelta&) {
-    int n=x.size();
-    for (int i=0; i<n-1; i++) {
-      for (int j = i + 1; j < n; j++) {
-	//if j can't be left, right, or down, then must be up
-	if ((x[j].min() + w[j] > x[i].max()) && // j cannot be left
-	    (x[i].min() + w[i] > x[j].max()) && // j cannot be right
-	    (y[j].min() + h[j] > y[i].max()))   // j cannot be down
-	  GECODE_ME_CHECK(y[j].gq(home, y[i].min()+h[i])); // j is up
-
-	//if j can't be left, right, or up, then must be down
-	if ((x[j].min() + w[j] > x[i].max()) && // j cannot be left
-	    (x[i].min() + w[i] > x[j].max()) && // j cannot be right
-	    (y[i].min() + h[i] > y[j].max()))   // j cannot be up
-	  GECODE_ME_CHECK(y[i].gq(home, y[j].min()+h[j])); // j is down
-
-	//if j can't be left, up, or down, then must be right
-	if ((x[j].min() + w[j] > x[i].max()) && // j cannot be left
-	    (y[i].min() + h[i] > y[j].max()) && // j cannot be up
-	    (y[j].min() + h[j] > y[i].max()))   // j cannot be down
-	  GECODE_ME_CHECK(x[j].gq(home, x[i].min()+w[i])); // j is right
-
-	//if j can't be right, up, or down, then must be left
-	if ((x[i].min() + w[i] > x[j].max()) && // j cannot be right
-	    (y[i].min() + h[i] > y[j].max()) && // j cannot be up
-	    (y[j].min() + h[j] > y[i].max()))   // j cannot be down
-	  GECODE_ME_CHECK(x[i].gq(home, x[j].min()+w[j])); // j is left
-      }
-    }
-
-    bool subsumed = false;
-    int i,j=0;
-    while (subsumed && i<x.size()-1){
-      subsumed =
-	(x[j].min() >= x[i].max()+w[i]) || // j is on the right of i
-	(x[i].min() >= x[j].max()+w[j]) || // j is on the left of i
-	(y[j].min() >= y[i].max()+h[i]) || // j is above i
-	(y[i].min() >= y[j].max()+h[j]);   // j is below i
-      if (++j >= x.size()){
-	i++;
-	j=i+1;
-      }
-    }
-
-    if (subsumed)
-      return home.ES_SUBSUMED(*this);
-    else
-      return ES_FIX;
+  // Return whether the reported packing must be deterministic
+  bool deterministic(void) const {
+    return _deterministic.value();
   }
-
-  // Dispose propagator and return its size
-  virtual size_t dispose(Space& home) {
-    x.cancel(home,*this,PC_INT_BND);
-    y.cancel(home,*this,PC_INT_BND);
-    (void) Propagator::dispose(home);
-    return sizeof(*this);
+  // Return whether to run several branchings concurrently
+  bool portfolio(void) const {
+    return _portfolio.value();
   }
-}; // end of class NoOverlap
-
-/*
- * Post the constraint that the rectangles defined by the coordinates
- * x and y and width w and height h do not overlap.
- *
- * This is the function that you will call from your model. The best
- * is to paste the entire file into your model.
- */
-void nooverlap2(Home home,
-               const IntVarArgs& x, const IntArgs& w,
-               const IntVarArgs& y, const IntArgs& h) {
-  // Check whether the arguments make sense
-  if ((x.size() != y.size()) || (x.size() != w.size()) ||
-      (y.size() != h.size()))
-    throw ArgumentSizeMismatch("nooverlap");
-  // Never post a propagator in a failed space
-  if (home.failed()) return;
-  // Set up array of views for the coordinates
-  ViewArray<IntView> vx(home,x);
-  ViewArray<IntView> vy(home,y);
-  // Set up arrays (allocated in home) for width and height and initialize
-  int* wc = static_cast<Space&>(home).alloc<int>(x.size());
-  int* hc = static_cast<Space&>(home).alloc<int>(y.size());
-  for (int i=x.size(); i--; ) {
-    wc[i]=w[i]; hc[i]=h[i];
-  }
-  // If posting failed, fail space
-  if (NoOverlap::post(home,vx,wc,vy,hc) != ES_OK)
-    home.fail();
-}
-
-
-
-
-
+  // Return how to search for the smallest side
+  int sides(void) const {
+    return _sides.value();
+  }
+  // Return the known lower bound for the side (0 if none)
+  unsigned int lower(void) const {
+    return _lower.value();
+  }
+  // Set the known lower bound for the side to v
+  void lower(unsigned int v) {
+    _lower.value(v);
+  }
+  // Return the known upper bound for the side (0 if none)
+  unsigned int upper(void) const {
+    return _upper.value();
+  }
+  // Set the known upper bound for the side to v
+  void upper(unsigned int v) {
+    _upper.value(v);
+  }
+  // Return the file with the results of earlier runs (NULL if none)
+  const char* cache(void) const {
+    return _cache.value();
+  }
+  // Return the neighbourhood for large neighbourhood search
+  int lns(void) const {
+    return _lns.value();
+  }
+  // Return the percentage of the squares freed per neighbourhood
+  unsigned int free(void) const {
+    return _free.value();
+  }
+  // Return the number of neighbourhoods to try (0 for no limit)
+  unsigned int restarts(void) const {
+    return _restarts.value();
+  }
+};
 
 class Square : public Script {
 protected:
@@ -197,28 +205,31 @@ private:
   static bool filter(const Space& home, IntVar x, int i){
     return x.size() >= 0.2 * size(i);
   }
-  // function for initial domain reduction (forbidden gaps)
+  /*
+   * function for initial domain reduction (forbidden gaps)
+   *
+   * Returns the largest forbidden gap between square i and the border,
+   * or -1 if there is none, only this gap is excluded from the
+   * coordinates of the square. The gap g is the largest one whose
+   * threshold[g-2] (from the literature) the size reaches. The table
+   * ends at size 45, bigger sizes conservatively keep its last gap 10.
+   */
   static int forbiddenGap (int i){
-    if (size(i)==45)
-      return 10;
-    if (size(i)>=34)
-      return 9;
-    if (size(i)>=30)
-      return 8;
-    if (size(i)>=22)
-      return 7;
-    if (size(i)>=18)
-      return 6;
-    if (size(i)>=12)
-      return 5;
-    if (size(i)>=9)
-      return 4;
-    if (size(i)>=5)
-      return 3;
-    if (size(i)>=2)
-      return 2;
+    static const int threshold[] = {2, 5, 9, 12, 18, 22, 30, 34, 45};
+    int g = -1;
+    for (int k=0; (k < 9) && (size(i) >= threshold[k]); k++)
+      g = k+2;
+    return g;
+  }
+
+  // post interval branching on coordinates c, with the percentage
+  // adapted per square and the variable selection from opt
+  void interval(const IntVarArray& c, const SquareOptions& opt) {
+    if (opt.adaptive())
+      ::interval(*this, c, IntArgs::create(n-1,n,-1), 0.1, 0.4,
+                 opt.select());
     else
-      return -1;
+      ::interval(*this, c, IntArgs::create(n-1,n,-1), 0.2, opt.select());
   }
 
 public:
@@ -229,26 +240,56 @@ public:
     BRANCH_LEFT_FIRST, ///< Try to place squares from left to right
     BRANCH_TOP_FIRST,  ///< Try to place squares from top to bottom
     BRANCH_INTERVAL,   ///< Split x, assign x, split y, then assign y
-    BRANCH_SPLIT       ///< Split x, split y, assign x, then assign y
+    BRANCH_SPLIT,      ///< Split x, split y, assign x, then assign y
+    BRANCH_GRID,       ///< Split x and y of the biggest squares first
+    BRANCH_GRID_REGION ///< Split x and y of the least free squares first
   };
   // Model variants
   enum {
     MODEL_NO_PROP,     ///< do not use external propagator
     MODEL_PROP         ///< use external propagator (function nooverlap)
   };
+  // Symmetry breaking variants
+  enum {
+    SYMMETRY_NONE,     ///< no symmetry breaking
+    SYMMETRY_MIRROR,   ///< biggest square in the lower left eighth
+    SYMMETRY_DOMINANCE ///< bottom-left normal form, biggest square below
+                       ///< the diagonal
+  };
+  // Propagation variants for MODEL_PROP are the filtering algorithms
+  // of the no-overlap propagator (see NoOverlapFilter)
   
-  Square(const SizeOptions& opt): Script(opt) {
-    n = opt.size();
+  Square(const SquareOptions& opt) : Square(opt, opt.branching()) {}
+
+  // Create model with branching variant branching instead of the one
+  // from opt, with the side fixed to side if side > 0, and without
+  // symmetry breaking unless symmetry (n must be set to the size from
+  // opt, models are created by several threads)
+  Square(const SquareOptions& opt, int branching, int side=0,
+         bool symmetry=true)
+    : Script(opt) {
     double ceilSqrt = ceil(sqrt(n));
-    // Minimum value for s: sum of areas of all the squares
-    // Maximum value for s: n*ceil(sqrt(n)), which gives a total area
-    // of at least n*n*n for the box, which can be divided into n square
-    // sub-boxes of size n, so each sub-box can contain one square of
-    // k (1 <= k <= n)
-    s = IntVar(*this, ceil(sqrt(n*(n+1)*(2*n+1)/6)), n*ceilSqrt);
-    // Square of size 1 are ignored (only n-1 variables)
-    x = IntVarArray(*this, n-1, 0, n*ceilSqrt-1);
-    y = IntVarArray(*this, n-1, 0, n*ceilSqrt-1);
+    if (side > 0) {
+      // The coordinates only range over the fixed box
+      s = IntVar(*this, side, side);
+      x = IntVarArray(*this, n-1, 0, side-1);
+      y = IntVarArray(*this, n-1, 0, side-1);
+    } else {
+      // Minimum value for s: sum of areas of all the squares
+      // Maximum value for s: n*ceil(sqrt(n)), which gives a total area
+      // of at least n*n*n for the box, which can be divided into n
+      // square sub-boxes of size n, so each sub-box can contain one
+      // square of k (1 <= k <= n)
+      s = IntVar(*this, ceil(sqrt(n*(n+1)*(2*n+1)/6)), n*ceilSqrt);
+      // Square of size 1 are ignored (only n-1 variables)
+      x = IntVarArray(*this, n-1, 0, n*ceilSqrt-1);
+      y = IntVarArray(*this, n-1, 0, n*ceilSqrt-1);
+      // Known bounds (from earlier runs, for example)
+      if (opt.lower() > 0)
+        rel(*this, s >= static_cast<int>(opt.lower()));
+      if (opt.upper() > 0)
+        rel(*this, s <= static_cast<int>(opt.upper()));
+    }
 
     
     // max coordinates depending on the size of the squares
@@ -258,12 +299,24 @@ public:
     }
 
     // symmetry removal
-    rel(*this, x[0]<=(s-n)/2);
-    rel(*this, y[0]<=x[0]);
+    switch (symmetry ? opt.symmetry() : SYMMETRY_NONE) {
+    case SYMMETRY_MIRROR:
+      // Mirroring and swapping the axes move the biggest square into
+      // the lower left eighth of the box
+      rel(*this, x[0]<=(s-n)/2);
+      rel(*this, y[0]<=x[0]);
+      break;
+    case SYMMETRY_DOMINANCE:
+      // Pushing squares left and down does not keep the biggest one in
+      // the left half, but swapping the axes keeps the normal form
+      bottomleft(*this, x, y, IntArgs::create(n-1,n,-1));
+      rel(*this, y[0]<=x[0]);
+      break;
+    }
 
     // initial domain reduction (forbidden gaps)
     for (int i=0; i<n-1; i++) {
-      if (size(i)<=45 || size(i)>=2){
+      if (forbiddenGap(i) > 0){
 	rel(*this, x[i]!=forbiddenGap(i));
 	rel(*this, y[i]!=forbiddenGap(i));
       }
@@ -277,11 +330,6 @@ public:
       }
     }
 
-    // symmetry removal
-    rel(*this, x[0]<=(s-n)/2);
-    rel(*this, y[0]<=x[0]);
-
-    
     // Constraint no overlap - disjoint
     switch (opt.model()) {
       case MODEL_NO_PROP:
@@ -302,70 +350,66 @@ public:
 
       nooverlap2(*this,
 		IntVarArgs(x), IntArgs(n-1, sArr),
-		IntVarArgs(y), IntArgs(n-1, sArr));
+		IntVarArgs(y), IntArgs(n-1, sArr),
+		static_cast<NoOverlapFilter>(opt.propagation()));
       break;
     }
 
     // Constraint no overlap - cumulative
-    for (int k=0; k<n*ceilSqrt; k++){
-      // boolean array for the reified constraint
-      // bc[i]=true if the square of index i have a non-empty
-      // intersection with column k
-      // br[i]=true if the square of index i have a non-empty
-      // intersection with row k
-      BoolVarArray bc(*this, n-1, 0, 1);
-      BoolVarArray br(*this, n-1, 0, 1);
-      for (int i=0; i<n-1; i++){
-	dom(*this, x[i], k-size(i)+1, k, bc[i]);
-	dom(*this, y[i], k-size(i)+1, k, br[i]);
-      }
-      // The sum of the sizes of all squares having non-empty
-      // intersection with column/row k must be lower or equal to s
-      // The size of one square is added in the sum if and only if
-      // bc/br=true
-      rel(*this, sum(IntArgs::create(n-1,n,-1), bc) <= s);
-      rel(*this, sum(IntArgs::create(n-1,n,-1), br) <= s);
-    }
+    // Projected on the x-axis (y-axis), the squares form a cumulative
+    // resource: the sum of the sizes of all squares having non-empty
+    // intersection with a column (row) must be lower or equal to s
+    cumulative2(*this, s, x,
+                IntArgs::create(n-1,n,-1), IntArgs::create(n-1,n,-1));
+    cumulative2(*this, s, y,
+                IntArgs::create(n-1,n,-1), IntArgs::create(n-1,n,-1));
 
     // Branching
     branch(*this, s, INT_VAL_MIN());
-    if (opt.branching() == BRANCH_X_FIRST) {
+    if (branching == BRANCH_X_FIRST) {
       branch(*this, x, INT_VAR_SIZE_MIN(), INT_VAL_MIN());
       branch(*this, y, INT_VAR_SIZE_MIN(), INT_VAL_MIN());
     }
-    else if (opt.branching() == BRANCH_BIG_FIRST) {
+    else if (branching == BRANCH_BIG_FIRST) {
       for (int i = 0; i<n-1; i++){
 	      branch(*this, x[i], INT_VAL_MIN());
 	      branch(*this, y[i], INT_VAL_MIN());
       }
     }
-    else if (opt.branching() == BRANCH_LEFT_FIRST) {
+    else if (branching == BRANCH_LEFT_FIRST) {
       branch(*this, x, INT_VAR_MIN_MIN(), INT_VAL_MIN());
       branch(*this, y, INT_VAR_SIZE_MIN(), INT_VAL_MIN());
     }
-    else if (opt.branching() == BRANCH_TOP_FIRST) {
+    else if (branching == BRANCH_TOP_FIRST) {
       branch(*this, y, INT_VAR_MAX_MAX(), INT_VAL_MAX());
       branch(*this, x, INT_VAR_SIZE_MIN(), INT_VAL_MAX());
-    } else if (opt.branching() == BRANCH_INTERVAL) {
+    } else if (branching == BRANCH_INTERVAL) {
       /*
       branch(*this, x, INT_VAR_NONE(), INT_VAL_SPLIT_MIN(), &filter);
       branch(*this, x, INT_VAR_NONE(), INT_VAL_MIN());
       branch(*this, y, INT_VAR_NONE(), INT_VAL_SPLIT_MIN(), &filter);
       branch(*this, y, INT_VAR_NONE(), INT_VAL_MIN());
       */
-      interval(*this, x, IntArgs::create(n-1,n,-1), 0.2);
+      interval(x, opt);
       branch(*this, x, INT_VAR_NONE(), INT_VAL_MIN());
-      interval(*this, y, IntArgs::create(n-1,n,-1), 0.2);
+      interval(y, opt);
       branch(*this, y, INT_VAR_NONE(), INT_VAL_MIN());
-    } else if (opt.branching() == BRANCH_SPLIT) {
+    } else if (branching == BRANCH_SPLIT) {
       /*
       branch(*this, x, INT_VAR_NONE(), INT_VAL_SPLIT_MIN(), &filter);
       branch(*this, y, INT_VAR_NONE(), INT_VAL_SPLIT_MIN(), &filter);
       branch(*this, x, INT_VAR_NONE(), INT_VAL_MIN());
       branch(*this, y, INT_VAR_NONE(), INT_VAL_MIN());
       */
-      interval(*this, x, IntArgs::create(n-1,n,-1), 0.2);
-      interval(*this, y, IntArgs::create(n-1,n,-1), 0.2);
+      interval(x, opt);
+      interval(y, opt);
+      branch(*this, x, INT_VAR_NONE(), INT_VAL_MIN());
+      branch(*this, y, INT_VAR_NONE(), INT_VAL_MIN());
+    } else if ((branching == BRANCH_GRID) ||
+               (branching == BRANCH_GRID_REGION)) {
+      grid(*this, x, IntArgs::create(n-1,n,-1),
+           y, IntArgs::create(n-1,n,-1), 0.2,
+           (branching == BRANCH_GRID) ? GRID_AREA_MAX : GRID_REGION_MIN);
       branch(*this, x, INT_VAR_NONE(), INT_VAL_MIN());
       branch(*this, y, INT_VAR_NONE(), INT_VAL_MIN());
     }
@@ -382,6 +426,40 @@ public:
     return new Square(share,*this);
   }
 
+  // Constrain the side to be smaller than in the best solution so far
+  virtual void constrain(const Space& best) {
+    rel(*this, s < static_cast<const Square&>(best).s.val());
+  }
+
+  // Return the side of the enclosing box (in a solution)
+  int side(void) const {
+    return s.val();
+  }
+  // Return the smallest side of the enclosing box left
+  int minside(void) const {
+    return s.min();
+  }
+  // Return the largest side of the enclosing box left
+  int maxside(void) const {
+    return s.max();
+  }
+  // Fix the side of the enclosing box to v
+  void side(int v) {
+    rel(*this, s == v);
+  }
+  // Fix square i (of size n-i) at coordinates px and py
+  void place(int i, int px, int py) {
+    rel(*this, x[i] == px);
+    rel(*this, y[i] == py);
+  }
+  // Store the coordinates of the squares (in a solution) in px and py
+  void packing(std::vector<int>& px, std::vector<int>& py) const {
+    px.clear(); py.clear();
+    for (int i=0; i<x.size(); i++) {
+      px.push_back(x[i].val()); py.push_back(y[i].val());
+    }
+  }
+
   virtual void print(std::ostream& os) const {
     os << "s = " << s << std::endl << std::endl;
     for (int i = 0; i<x.size(); i++){
@@ -390,9 +468,464 @@ public:
   }
 }; // end of class Square
 
+// Record in cache the packing best (if not NULL) and the proven lower
+// bound lower for the side
+void record(ResultCache& cache, const Square* best, int lower) {
+  std::vector<int> px, py;
+  if (best != NULL)
+    best->packing(px, py);
+  cache.record(n, lower, (best != NULL) ? best->side() : 0, px, py);
+}
+
+/*
+ * Run the search in deterministic mode
+ *
+ * Branch-and-bound with all threads finds the smallest side. Which
+ * packing is found for that side depends on the timing of the threads,
+ * so the packing that is reported is the first one for that side found
+ * by a sequential search, the same as without threads.
+ */
+void deterministic(const SquareOptions& opt, ResultCache& cache) {
+  Search::Options so;
+  so.threads = opt.threads();
+  so.c_d = opt.c_d();
+  so.a_d = opt.a_d();
+  Search::TimeStop* ts = NULL;
+  if (opt.time() > 0)
+    so.stop = ts = new Search::TimeStop(opt.time());
+
+  Square* root = new Square(opt);
+  BAB<Square> e(root,so);
+  delete root;
+  Square* best = NULL;
+  while (Square* t = e.next()) {
+    delete best; best = t;
+  }
+  Search::Statistics stat = e.statistics();
+  if (best == NULL) {
+    std::cout << "No solution found" << std::endl;
+  } else {
+    // Find the canonical packing for the smallest side
+    root = new Square(opt);
+    root->side(best->side());
+    DFS<Square> d(root);
+    delete root;
+    Square* canonical = d.next();
+    canonical->print(std::cout);
+    record(cache, canonical, e.stopped() ? 0 : canonical->side());
+    stat += d.statistics();
+    delete canonical;
+    delete best;
+  }
+  std::cout << std::endl
+            << "Search " << (e.stopped() ? "stopped" : "complete")
+            << std::endl
+            << "\tnodes:        " << stat.node << std::endl
+            << "\tfailures:     " << stat.fail << std::endl
+            << "\tpropagations: " << stat.propagate << std::endl;
+  delete ts;
+}
+
+/*
+ * Search for a packing with the side fixed to k
+ *
+ * Returns the packing if there is one, otherwise NULL. The search
+ * uses the threads and the time limit from opt, proven is set to
+ * whether the search has been complete.
+ */
+Square* solve_side(const SquareOptions& opt, int k, bool& proven,
+                   Search::Statistics& stat) {
+  Search::Options so;
+  so.threads = opt.threads();
+  so.c_d = opt.c_d();
+  so.a_d = opt.a_d();
+  Search::TimeStop* ts = NULL;
+  if (opt.time() > 0)
+    so.stop = ts = new Search::TimeStop(opt.time());
+  Square* root = new Square(opt, opt.branching(), k);
+  DFS<Square> e(root, so);
+  delete root;
+  Square* sol = e.next();
+  proven = (sol != NULL) || !e.stopped();
+  stat += e.statistics();
+  delete ts;
+  return sol;
+}
+
+/*
+ * Search for the smallest side with one search per fixed side
+ *
+ * The sides are either tried in increasing order from the lower bound
+ * of the model, or bisected between the lower bound and the upper
+ * bound (from opt or the model). Every search is limited by the time
+ * limit of opt, a side whose search runs out of time counts as
+ * infeasible and the result is then not proven to be the best.
+ */
+void sides(const SquareOptions& opt, ResultCache& cache) {
+  Square* root = new Square(opt);
+  (void) root->status();
+  int lo = root->minside(), hi = root->maxside();
+  delete root;
+  // A bigger box fits any packing, so an infeasible side k proves
+  // that the side is at least k+1
+  int lower = lo;
+
+  Search::Statistics stat;
+  Square* best = NULL;
+  bool optimal = true;
+  if (opt.sides() == SIDES_UP) {
+    for (int k=lo; (best == NULL) && (k <= hi); k++) {
+      bool proven;
+      best = solve_side(opt, k, proven, stat);
+      optimal = optimal && proven;
+      if ((best == NULL) && proven)
+        lower = std::max(lower, k+1);
+      std::cout << "side " << k << ": "
+                << ((best != NULL) ? "packing" :
+                    (proven ? "infeasible" : "unknown")) << std::endl;
+    }
+  } else {
+    // Invariant: all sides below lo are infeasible, and side hi is the
+    // side of best (or beyond the upper bound)
+    hi++;
+    while (lo < hi) {
+      int k = lo + (hi - lo) / 2;
+      bool proven;
+      Square* s = solve_side(opt, k, proven, stat);
+      optimal = optimal && proven;
+      std::cout << "side " << k << ": "
+                << ((s != NULL) ? "packing" :
+                    (proven ? "infeasible" : "unknown")) << std::endl;
+      if (s != NULL) {
+        delete best; best = s; hi = k;
+      } else {
+        if (proven)
+          lower = std::max(lower, k+1);
+        lo = k+1;
+      }
+    }
+  }
+  if (best == NULL) {
+    std::cout << "No solution found" << std::endl;
+  } else {
+    std::cout << std::endl;
+    best->print(std::cout);
+    std::cout << std::endl << (optimal ? "Optimal" : "Not proven optimal")
+              << std::endl;
+  }
+  record(cache, best, (optimal && (best != NULL)) ? best->side() : lower);
+  delete best;
+  std::cout << "\tnodes:        " << stat.node << std::endl
+            << "\tfailures:     " << stat.fail << std::endl
+            << "\tpropagations: " << stat.propagate << std::endl;
+}
+
+/*
+ * Large neighbourhood search
+ *
+ * Starting from a first packing (see run), every step tries to fit
+ * the best packing so far into a box one smaller.
+ * The squares of a neighbourhood are freed, the others keep their
+ * place (unless they stick out of the smaller box), and a search
+ * limited to a number of failures (from opt, 1000 if not set) looks
+ * for a packing. The steps stop after the number of restarts or the
+ * time limit from opt, or when the side is proven to be the smallest.
+ */
+class LNS {
+protected:
+  // When to give up (if limited)
+  bool limited;
+  std::chrono::steady_clock::time_point end;
+  // Stop a search after more than fails failures or when time is over
+  class Stop : public Search::Stop {
+  protected:
+    LNS& l;
+    unsigned long int fails;
+  public:
+    Stop(LNS& l0, unsigned long int f) : l(l0), fails(f) {}
+    virtual bool stop(const Search::Statistics& s, const Search::Options&) {
+      return (s.fail > fails) || l.over();
+    }
+  };
+  // Best packing so far, its side and coordinates
+  Square* best;
+  int side;
+  std::vector<int> px, py;
+  // Random numbers for the neighbourhoods
+  std::mt19937 rnd;
+public:
+  // Initialize with time limit of t milliseconds (none if 0)
+  LNS(unsigned int t, unsigned int seed)
+    : limited(t > 0),
+      end(std::chrono::steady_clock::now() + std::chrono::milliseconds(t)),
+      best(NULL), side(0), rnd(seed) {}
+  ~LNS(void) {
+    delete best;
+  }
+  // Return whether the time is over
+  bool over(void) const {
+    return limited && (std::chrono::steady_clock::now() > end);
+  }
+  // Compute in f which squares to free for a box of side k
+  void neighbourhood(const SquareOptions& opt, int k, std::vector<bool>& f) {
+    int m = static_cast<int>(px.size());
+    f.assign(m, false);
+    if (opt.lns() == LNS_RANDOM) {
+      std::vector<int> p(m);
+      for (int i=0; i<m; i++)
+        p[i] = i;
+      std::shuffle(p.begin(), p.end(), rnd);
+      int l = std::max(1, static_cast<int>(m * opt.free() / 100));
+      for (int i=0; i<std::min(l,m); i++)
+        f[p[i]] = true;
+    } else {
+      // A window covering about the percentage of the box
+      int w = std::max(1, static_cast<int>
+                       (ceil(k * sqrt(opt.free() / 100.0))));
+      w = std::min(w, k);
+      int wx = std::uniform_int_distribution<int>(0, k-w)(rnd);
+      int wy = std::uniform_int_distribution<int>(0, k-w)(rnd);
+      for (int i=0; i<m; i++)
+        f[i] = (px[i] < wx+w) && (wx < px[i]+n-i) &&
+          (py[i] < wy+w) && (wy < py[i]+n-i);
+    }
+    // Squares sticking out of the box must move
+    for (int i=0; i<m; i++)
+      if ((px[i]+n-i > k) || (py[i]+n-i > k))
+        f[i] = true;
+  }
+  // Return the first packing in root found within fails failures (NULL
+  // if none), stopped tells whether the search has been stopped
+  Square* first(Square* root, Search::Options& so, unsigned long int fails,
+                Search::Statistics& stat, bool& stopped) {
+    Stop stop(*this, fails);
+    so.stop = &stop;
+    DFS<Square> e(root, so);
+    delete root;
+    Square* s = e.next();
+    stopped = e.stopped();
+    stat += e.statistics();
+    so.stop = NULL;
+    return s;
+  }
+  // Make s with side k the best packing
+  void improve(Square* s, int k) {
+    delete best; best = s;
+    side = k; best->packing(px, py);
+  }
+  /*
+   * Run the search, print the result and record it in cache
+   *
+   * The search starts from the packing in the cache if there is one.
+   * Otherwise the sides are bisected with the failure limit, and only
+   * if that finds nothing from any packing with the largest side. The
+   * neighbourhoods fix squares of the best packing, which can break the
+   * symmetry rules, so they are posted without.
+   */
+  void run(const SquareOptions& opt, ResultCache& cache) {
+    Square* root = new Square(opt);
+    (void) root->status();
+    int lo = root->minside(), hi = root->maxside();
+    delete root;
+    unsigned long int fails = (opt.fail() > 0) ? opt.fail() : 1000;
+
+    Search::Statistics stat;
+    Search::Options so;
+    so.c_d = opt.c_d();
+    so.a_d = opt.a_d();
+    bool stopped;
+    const ResultCache::Entry* c = cache.get(opt.size());
+    if ((c != NULL) && c->packed() && (c->upper <= hi)) {
+      root = new Square(opt, opt.branching(), c->upper, false);
+      for (int i=0; i<n-1; i++)
+        root->place(i, c->x[i], c->y[i]);
+      if (Square* s = first(root, so, ULONG_MAX, stat, stopped))
+        improve(s, c->upper);
+    }
+    if (best == NULL) {
+      int a = lo, b = hi;
+      while ((a < b) && !over()) {
+        int k = a + (b-a)/2;
+        root = new Square(opt, opt.branching(), k);
+        if (Square* s = first(root, so, fails, stat, stopped)) {
+          improve(s, k); b = k;
+        } else {
+          // Smaller boxes cannot hold a packing either
+          if (!stopped)
+            lo = k+1;
+          a = k+1;
+        }
+      }
+    }
+    if (best == NULL) {
+      root = new Square(opt, opt.branching(), hi);
+      if (Square* s = first(root, so, ULONG_MAX, stat, stopped))
+        improve(s, hi);
+    }
+    bool optimal = (side == lo);
+    unsigned int r = 0;
+    while ((side > 0) && !optimal && !over() &&
+           ((opt.restarts() == 0) || (r < opt.restarts()))) {
+      r++;
+      int k = side-1;
+      std::vector<bool> f;
+      neighbourhood(opt, k, f);
+      bool all = true;
+      root = new Square(opt, opt.branching(), k, false);
+      for (int i=0; i<static_cast<int>(f.size()); i++)
+        if (!f[i]) {
+          root->place(i, px[i], py[i]); all = false;
+        }
+      if (Square* s = first(root, so, fails, stat, stopped)) {
+        improve(s, k);
+        optimal = (side == lo);
+        std::cout << "side " << side << " after " << r
+                  << " neighbourhoods" << std::endl;
+      } else if (all && !stopped) {
+        // Nothing was fixed, so there is no packing with side k
+        optimal = true;
+      }
+    }
+    if (best == NULL) {
+      std::cout << "No solution found" << std::endl;
+    } else {
+      std::cout << std::endl;
+      best->print(std::cout);
+      std::cout << std::endl << (optimal ? "Optimal" : "Not proven optimal")
+                << std::endl;
+    }
+    record(cache, best, optimal ? side : lo);
+    std::cout << "\tneighbourhoods: " << r << std::endl
+              << "\tnodes:          " << stat.node << std::endl
+              << "\tfailures:       " << stat.fail << std::endl
+              << "\tpropagations:   " << stat.propagate << std::endl;
+  }
+};
+
+/*
+ * Portfolio of branchings
+ *
+ * Every worker thread uses its own branching and tries the sides in
+ * increasing order, each side with a separate search. The workers
+ * share the smallest side that is not yet proven to be infeasible:
+ * a worker that proves a side infeasible moves the others on to the
+ * next side. A packing found for the shared side is therefore the
+ * best one, and all workers stop.
+ */
+class Portfolio {
+public:
+  // Branchings run by the workers and their names
+  static const int size = 8;
+  static const int branchings[size];
+  static const char* names[size];
+  // Smallest side that is not proven to be infeasible
+  std::atomic<int> lower;
+  // Whether the search is over
+  std::atomic<bool> done;
+  // Protects best and winner
+  std::mutex m;
+  // Best packing and the worker that found it
+  Square* best;
+  int winner;
+  // When to give up (if limited)
+  bool limited;
+  std::chrono::steady_clock::time_point end;
+
+  // Stop the search of a worker for side k
+  class Stop : public Search::Stop {
+  protected:
+    Portfolio& p;
+    int k;
+  public:
+    Stop(Portfolio& p0, int k0) : p(p0), k(k0) {}
+    virtual bool stop(const Search::Statistics&, const Search::Options&) {
+      if (p.limited && (std::chrono::steady_clock::now() > p.end))
+        p.done = true;
+      return p.done || (p.lower.load() > k);
+    }
+  };
+
+  // Initialize with time limit of t milliseconds (none if 0)
+  Portfolio(unsigned int t)
+    : lower(0), done(false), best(NULL), winner(-1), limited(t > 0),
+      end(std::chrono::steady_clock::now() + std::chrono::milliseconds(t)) {}
+  ~Portfolio(void) {
+    delete best;
+  }
+
+  // Run worker w
+  void work(const SquareOptions& opt, int w) {
+    Search::Options so;
+    so.c_d = opt.c_d();
+    so.a_d = opt.a_d();
+    while (!done) {
+      Square* root = new Square(opt, branchings[w]);
+      // No side is left in the model (for example, with an upper bound
+      // below the smallest side)
+      if (root->status() == SS_FAILED) {
+        delete root; done = true;
+        break;
+      }
+      // Sides smaller than in the model are infeasible anyway
+      int k = lower.load();
+      if ((root->minside() > k) &&
+          lower.compare_exchange_strong(k, root->minside()))
+        k = root->minside();
+      // All sides of the model are infeasible
+      if (k > root->maxside()) {
+        delete root; done = true;
+        break;
+      }
+      root->side(k);
+      Stop stop(*this, k);
+      so.stop = &stop;
+      DFS<Square> e(root, so);
+      delete root;
+      if (Square* s = e.next()) {
+        std::lock_guard<std::mutex> l(m);
+        if (!done) {
+          best = s; winner = w; done = true;
+        } else {
+          delete s;
+        }
+      } else if (!e.stopped()) {
+        // Side k is infeasible, move all workers on
+        lower.compare_exchange_strong(k, k+1);
+      }
+    }
+  }
+
+  // Run all workers, print the result and record it in cache
+  void run(const SquareOptions& opt, ResultCache& cache) {
+    std::vector<std::thread> ws;
+    for (int w=0; w<size; w++)
+      ws.push_back(std::thread(&Portfolio::work, this, std::cref(opt), w));
+    for (std::thread& t : ws)
+      t.join();
+    if (best == NULL) {
+      std::cout << "No solution found" << std::endl;
+    } else {
+      best->print(std::cout);
+      std::cout << std::endl << "Best packing found by branching "
+                << names[winner] << std::endl;
+    }
+    record(cache, best, lower.load());
+  }
+};
+
+const int Portfolio::branchings[Portfolio::size] = {
+  Square::BRANCH_SPLIT, Square::BRANCH_INTERVAL,
+  Square::BRANCH_GRID, Square::BRANCH_GRID_REGION,
+  Square::BRANCH_X_FIRST, Square::BRANCH_BIG_FIRST,
+  Square::BRANCH_LEFT_FIRST, Square::BRANCH_TOP_FIRST
+};
+const char* Portfolio::names[Portfolio::size] = {
+  "split", "interval", "grid", "grid-region", "x", "big", "left", "top"
+};
+
 int main(int argc, char* argv[]) {
   // commandline options
-  SizeOptions opt("Square Packing");
+  SquareOptions opt("Square Packing");
   opt.solutions(1);
   opt.size(5);
 
@@ -403,21 +936,97 @@ int main(int argc, char* argv[]) {
   opt.branching(Square::BRANCH_TOP_FIRST, "top", "top first");
   opt.branching(Square::BRANCH_INTERVAL, "interval", "interval");
   opt.branching(Square::BRANCH_SPLIT, "split", "split");
+  opt.branching(Square::BRANCH_GRID, "grid", "split x and y, biggest first");
+  opt.branching(Square::BRANCH_GRID_REGION, "grid-region",
+                "split x and y, least free first");
 
   opt.model(Square::MODEL_NO_PROP, 
             "noprop", "no extern no-overlap propagator");
   opt.model(Square::MODEL_PROP, 
-            "prop", "use extern no-overlap propagator");
+            "prop", "use extern no-overlap propagator "
+            "(prints only its runs and passes, also per thread)");
   opt.model(Square::MODEL_NO_PROP);
+
+  opt.symmetry(Square::SYMMETRY_MIRROR);
+  opt.symmetry(Square::SYMMETRY_NONE, "none", "no symmetry breaking");
+  opt.symmetry(Square::SYMMETRY_MIRROR,
+               "mirror", "biggest square in the lower left eighth");
+  opt.symmetry(Square::SYMMETRY_DOMINANCE,
+               "dominance", "no square can be pushed left or down");
+
+  opt.propagation(NOOVERLAP_SWEEP);
+  opt.propagation(NOOVERLAP_PAIRWISE,
+                  "pairwise", "check all pairs of squares");
+  opt.propagation(NOOVERLAP_SWEEP,
+                  "sweep", "sweep over compulsory parts");
+  opt.propagation(NOOVERLAP_INCREMENTAL,
+                  "incremental", "only check modified squares (advisors)");
+  opt.propagation(NOOVERLAP_ENERGETIC,
+                  "energetic", "sweep plus energetic reasoning");
+  opt.propagation(NOOVERLAP_SIMD,
+                  "simd",
+                  "check all pairs of squares with AVX2 "
+                  "(as pairwise without AVX2)");
   
   opt.parse(argc,argv);
   if (opt.size() < 2) {
     std::cerr << "Error: size must be greater than 1" << std::endl;
     return 1;
   }
+  n = opt.size();
   
+  // Solved sizes are looked up, the others start from the known bounds
+  ResultCache cache(opt.cache());
+  if (cache.solved(opt.size())) {
+    cache.print(opt.size(), std::cout);
+    std::cout << std::endl << "Optimal (from " << opt.cache() << ")"
+              << std::endl;
+    return 0;
+  }
+  int lower, upper;
+  cache.bounds(opt.size(), lower, upper);
+  if (lower > static_cast<int>(opt.lower()))
+    opt.lower(lower);
+  if ((upper > 0) && ((opt.upper() == 0) ||
+                      (upper < static_cast<int>(opt.upper()))))
+    opt.upper(upper);
+
   // run script
-  Script::run<Square,BAB,SizeOptions>(opt);
+  if (opt.portfolio()) {
+    Portfolio p(opt.time());
+    p.run(opt, cache);
+  } else if (opt.lns() != LNS_NONE) {
+    LNS l(opt.time(), opt.seed());
+    l.run(opt, cache);
+  } else if (opt.deterministic()) {
+    deterministic(opt, cache);
+  } else if (opt.sides() != SIDES_BAB) {
+    sides(opt, cache);
+  } else if (opt.cache() != NULL) {
+    // The driver does not return the best packing, which is needed to
+    // update the cache
+    deterministic(opt, cache);
+  } else {
+    // The first solution is only the best one for sequential search
+    if (opt.threads() != 1.0)
+      opt.solutions(0);
+    Script::run<Square,BAB,SquareOptions>(opt);
+  }
+  if (opt.model() == Square::MODEL_PROP) {
+    // Only the runs of the no-overlap propagator are counted per thread
+    NoOverlapStatistics::Counts c = NoOverlapStatistics::total();
+    std::cout << "\tno-overlap runs: " << c.runs
+              << ", passes: " << c.passes << std::endl;
+    int t = NoOverlapStatistics::size();
+    for (int i=0; (t > 1) && (i < t); i++)
+      std::cout << "\t\tthread " << i << ": "
+                << NoOverlapStatistics::thread(i).runs << " no-overlap runs"
+                << std::endl;
+  }
+  if (!cache.save()) {
+    std::cerr << "Error: cannot write " << opt.cache() << std::endl;
+    return 1;
+  }
   return 0;
 }
 
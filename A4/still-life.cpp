@@ -0,0 +1,531 @@
+/*
+ *  Main author:
+ *     Yumen & Marion
+ *
+ *  Copyright:
+ *     Yumen & Marion, 2026
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining
+ *  a copy of this software and associated documentation files (the
+ *  "Software"), to deal in the Software without restriction, including
+ *  without limitation the rights to use, copy, modify, merge, publish,
+ *  distribute, sublicense, and/or sell copies of the Software, and to
+ *  permit persons to whom the Software is furnished to do so, subject to
+ *  the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be
+ *  included in all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ *  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ *  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ *  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ *  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+#include <gecode/int.hh>
+#include <algorithm>
+
+using namespace Gecode;
+using namespace Gecode::Int;
+
+/*
+ * Still 3x3 patterns
+ *
+ * The 3x3 neighbourhood of a cell is a 9-bit pattern (bit 3*di+dj for
+ * row offset di and column offset dj, the cell itself is bit 4). The
+ * cell is still if it is live with two or three live neighbours, or
+ * dead without exactly three.
+ */
+class StillPatterns {
+public:
+  bool still[512];
+  StillPatterns(void) {
+    for (int p=0; p<512; p++) {
+      int live = 0;
+      for (int k=0; k<9; k++)
+        if ((k != 4) && ((p >> k) & 1))
+          live++;
+      still[p] = ((p >> 4) & 1) ? ((live == 2) || (live == 3))
+        : (live != 3);
+    }
+  }
+};
+// Return whether pattern p is still
+inline bool still(int p) {
+  static const StillPatterns t;
+  return t.still[p];
+}
+
+/*
+ * Supports of partially fixed 3x3 patterns
+ *
+ * A partially fixed pattern has a digit for each of its nine cells, 0
+ * for dead, 1 for live, and 2 for free (base 3, cell k has weight
+ * 3^k). Its supports are the cells that are live (bits 0 to 8) and
+ * dead (bits 9 to 17) in some still pattern that agrees with it, no
+ * supports means there is no such pattern.
+ */
+class StillSupports {
+public:
+  int sup[19683];
+  StillSupports(void) {
+    for (int c=19683; c--; )
+      sup[c] = 0;
+    // Every still pattern supports all its restrictions to fixed cells
+    for (int p=0; p<512; p++)
+      if (::still(p))
+        for (int fixed=0; fixed<512; fixed++) {
+          int c = 0;
+          for (int k=9; k--; )
+            c = 3*c + (((fixed >> k) & 1) ? ((p >> k) & 1) : 2);
+          sup[c] |= p | ((511 & ~p) << 9);
+        }
+  }
+};
+// Return the supports of the partially fixed pattern c
+inline int supports(int c) {
+  static const StillSupports t;
+  return t.sup[c];
+}
+
+/*
+ * The still-life propagator
+ *
+ * The cells of a board of width w are 0/1 views b, row by row. The
+ * cells in rows and columns l to u must be still, which the supports
+ * of their neighbourhoods tell: an unfixed cell without a live (dead)
+ * support is fixed to dead (live), no supports means failure.
+ *
+ * Advisors record the neighbourhoods around a modified cell in a
+ * queue, only those are examined again. The neighbourhoods around the
+ * cells the propagator fixes itself are added until the queue is empty.
+ */
+class StillLife : public Propagator {
+protected:
+  // The cells
+  ViewArray<IntView> b;
+  // The width of the board
+  int w;
+  // The cells in rows and columns l to u have to be still
+  int l, u;
+  // Centers of the neighbourhoods to examine
+  int* q;
+  // Number of neighbourhoods to examine
+  int nq;
+  // Whether the neighbourhood around a cell is in the queue
+  bool* qd;
+
+  // Advisor for a cell
+  class Cell : public Advisor {
+  public:
+    // Index of the cell
+    int i;
+    // Create advisor
+    Cell(Space& home, Propagator& p, Council<Cell>& co, int i0)
+      : Advisor(home,p,co), i(i0) {}
+    // Copy advisor during cloning
+    Cell(Space& home, bool share, Cell& a)
+      : Advisor(home,share,a), i(a.i) {}
+  };
+  // The advisors
+  Council<Cell> co;
+
+  // Return the index of cell k (0 to 8) around the cell with index m
+  int cell(int m, int k) const {
+    return m + (k/3-1)*w + k%3-1;
+  }
+  // Add the neighbourhoods containing the cell with index m to the queue
+  void enqueue(int m) {
+    int i = m / w, j = m % w;
+    for (int ci=std::max(l,i-1); ci<=std::min(u,i+1); ci++)
+      for (int cj=std::max(l,j-1); cj<=std::min(u,j+1); cj++)
+        if (!qd[ci*w+cj]) {
+          qd[ci*w+cj] = true; q[nq++] = ci*w+cj;
+        }
+  }
+
+public:
+  // Create propagator and initialize
+  StillLife(Home home, ViewArray<IntView>& b0, int w0, int l0, int u0)
+    : Propagator(home), b(b0), w(w0), l(l0), u(u0), nq(0), co(home) {
+    q = static_cast<Space&>(home).alloc<int>((u-l+1)*(u-l+1));
+    qd = static_cast<Space&>(home).alloc<bool>(b.size());
+    for (int i=b.size(); i--; )
+      qd[i] = false;
+    // All neighbourhoods have to be examined initially
+    for (int i=l; i<=u; i++)
+      for (int j=l; j<=u; j++) {
+        qd[i*w+j] = true; q[nq++] = i*w+j;
+      }
+    for (int i=b.size(); i--; )
+      if (!b[i].assigned())
+        b[i].subscribe(home,*new (home) Cell(home,*this,co,i));
+    // Advisors do not schedule the propagator, so do it here
+    IntView::schedule(home,*this,ME_INT_VAL);
+  }
+  // Post still-life propagator
+  static ExecStatus post(Home home, ViewArray<IntView>& b,
+                         int w, int l, int u) {
+    // Cells are either dead or live
+    for (int i=b.size(); i--; ) {
+      GECODE_ME_CHECK(b[i].gq(home,0));
+      GECODE_ME_CHECK(b[i].lq(home,1));
+    }
+    (void) new (home) StillLife(home,b,w,l,u);
+    return ES_OK;
+  }
+
+  // Copy constructor during cloning
+  StillLife(Space& home, bool share, StillLife& p)
+    : Propagator(home,share,p), w(p.w), l(p.l), u(p.u), nq(p.nq) {
+    b.update(home,share,p.b);
+    co.update(home,share,p.co);
+    // Also copy the queue
+    q = home.alloc<int>((u-l+1)*(u-l+1));
+    qd = home.alloc<bool>(b.size());
+    for (int i=nq; i--; )
+      q[i] = p.q[i];
+    for (int i=b.size(); i--; )
+      qd[i] = p.qd[i];
+  }
+  // Create copy during cloning
+  virtual Propagator* copy(Space& home, bool share) {
+    return new (home) StillLife(home,share,*this);
+  }
+
+  // Return cost (one table lookup per queued neighbourhood)
+  virtual PropCost cost(const Space&, const ModEventDelta&) const {
+    return PropCost::linear(PropCost::LO, b.size());
+  }
+
+  // Record the neighbourhoods around the modified cell
+  virtual ExecStatus advise(Space& home, Advisor& a0, const Delta&) {
+    Cell& a = static_cast<Cell&>(a0);
+    enqueue(a.i);
+    // A cell is assigned by any modification
+    return home.ES_NOFIX_DISPOSE(co,a);
+  }
+
+  // Perform propagation
+  virtual ExecStatus propagate(Space& home, const ModEventDelta&) {
+    while (nq > 0) {
+      int m = q[--nq];
+      qd[m] = false;
+      // The partially fixed pattern of the neighbourhood
+      int c = 0;
+      for (int k=9; k--; )
+        c = 3*c + (b[cell(m,k)].assigned() ? b[cell(m,k)].val() : 2);
+      int s = supports(c);
+      if (s == 0)
+        return ES_FAILED;
+      for (int k=0; k<9; k++) {
+        int i = cell(m,k);
+        if (!b[i].assigned()) {
+          if (!((s >> k) & 1)) {
+            GECODE_ME_CHECK(b[i].eq(home,0));
+            enqueue(i);
+          } else if (!((s >> (9+k)) & 1)) {
+            GECODE_ME_CHECK(b[i].eq(home,1));
+            enqueue(i);
+          }
+        }
+      }
+    }
+    // Once all cells are fixed, all neighbourhoods have been examined
+    if (co.empty())
+      return home.ES_SUBSUMED(*this);
+    return ES_FIX;
+  }
+
+  // Dispose propagator and return its size
+  virtual size_t dispose(Space& home) {
+    for (Advisors<Cell> as(co); as(); ++as)
+      b[as.advisor().i].cancel(home,as.advisor());
+    co.dispose(home);
+    (void) Propagator::dispose(home);
+    return sizeof(*this);
+  }
+}; // end of class StillLife
+
+/*
+ * Post the constraint that the cells in rows and columns l to u of the
+ * board b of width w (row by row, 0/1 values) are still. The cells
+ * around them must be part of b.
+ */
+void stilllife(Home home, const IntVarArgs& b, int w, int l, int u) {
+  // Check whether the arguments make sense
+  if ((w <= 0) || (b.size() != w*w))
+    throw ArgumentSizeMismatch("stilllife");
+  if ((l < 1) || (u > w-2))
+    throw OutOfLimits("stilllife");
+  // Never post a propagator in a failed space
+  if (home.failed()) return;
+  // Set up array of views for the cells
+  ViewArray<IntView> vb(home,b);
+  // If posting failed, fail space
+  if (StillLife::post(home,vb,w,l,u) != ES_OK)
+    home.fail();
+}
+
+/*
+ * The still-life bound propagator
+ *
+ * Bounds the number c of live cells on a board as for the still-life
+ * propagator from above. A row-by-row dynamic program over all pairs
+ * of rows is exact, but has 4^n states for n columns. So the columns
+ * l+1 to u-1 are split into strips of at most three, and the program
+ * runs on every strip with one more column on each side: the state is
+ * a pair of rows of the strip, the next row must keep the cells of
+ * the middle row in the strip still, and the value is the number of
+ * live cells in the strip. The strips only drop constraints and count
+ * every cell once, so the sum of their maxima is an upper bound.
+ *
+ * The rows only take values that agree with the fixed cells. Advisors
+ * record which strips see a modified cell, only those are solved
+ * again.
+ */
+class StillLifeBound : public Propagator {
+protected:
+  // The cells
+  ViewArray<IntView> b;
+  // The width of the board
+  int w;
+  // The cells in rows and columns l to u have to be still
+  int l, u;
+  // The number of live cells
+  IntView c;
+  // Number of strips
+  int ns;
+  // Bound for each strip
+  int* sb;
+  // Whether a strip has to be solved again
+  bool* sd;
+
+  // Advisor for a cell
+  class Cell : public Advisor {
+  public:
+    // Index of the cell
+    int i;
+    // Create advisor
+    Cell(Space& home, Propagator& p, Council<Cell>& co, int i0)
+      : Advisor(home,p,co), i(i0) {}
+    // Copy advisor during cloning
+    Cell(Space& home, bool share, Cell& a)
+      : Advisor(home,share,a), i(a.i) {}
+  };
+  // The advisors
+  Council<Cell> co;
+
+  // Maximal width of a strip
+  static const int strip = 3;
+  // Table of the rows p, q, and t (bit j is column j of a strip of
+  // width k with the columns around) that keep the cells of q still
+  class Rows {
+  public:
+    bool* still[strip+1];
+    Rows(void) {
+      for (int k=1; k<=strip; k++) {
+        int m = k+2;
+        still[k] = new bool[1 << (3*m)];
+        for (int r=0; r < (1 << (3*m)); r++) {
+          int p = r >> (2*m), q = (r >> m) & ((1 << m)-1),
+            t = r & ((1 << m)-1);
+          bool s = true;
+          for (int j=1; s && (j<=k); j++)
+            s = ::still(((p >> (j-1)) & 7) | (((q >> (j-1)) & 7) << 3) |
+                        (((t >> (j-1)) & 7) << 6));
+          still[k][r] = s;
+        }
+      }
+    }
+    ~Rows(void) {
+      for (int k=1; k<=strip; k++)
+        delete [] still[k];
+    }
+  };
+  // Return whether the rows p, q, and t of a strip of width k keep q still
+  static bool still(int k, int p, int q, int t) {
+    static const Rows r;
+    int m = k+2;
+    return r.still[k][(p << (2*m)) | (q << m) | t];
+  }
+
+  // Return the first column of strip s
+  int first(int s) const {
+    return l+1+strip*s;
+  }
+  // Return the width of strip s
+  int width(int s) const {
+    return std::min(strip, u-first(s));
+  }
+
+  // Return the largest number of live cells in strip s (-1 if none)
+  int solve(Space& home, int s) {
+    int k = width(s), m = k+2, a = first(s)-1;
+    int nm = 1 << m;
+    Region r(home);
+    int* f = r.alloc<int>(nm*nm);
+    int* g = r.alloc<int>(nm*nm);
+    // Live cells in the strip
+    int* lc = r.alloc<int>(nm);
+    for (int t=0; t<nm; t++) {
+      lc[t] = 0;
+      for (int j=1; j<=k; j++)
+        lc[t] += (t >> j) & 1;
+    }
+    for (int pq=nm*nm; pq--; )
+      f[pq] = -1;
+    for (int i=0; i<w; i++) {
+      // Fixed cells of the row and their values
+      int fixed = 0, val = 0;
+      for (int j=0; j<m; j++)
+        if (b[i*w+a+j].assigned()) {
+          fixed |= 1 << j;
+          if (b[i*w+a+j].val() == 1)
+            val |= 1 << j;
+        }
+      int free = (nm-1) & ~fixed;
+      for (int pq=nm*nm; pq--; )
+        g[pq] = -1;
+      for (int st=free; true; st=(st-1) & free) {
+        int t = val | st;
+        if (i == 0) {
+          // The row above the board is dead
+          g[t] = lc[t];
+        } else {
+          for (int pq=0; pq<nm*nm; pq++)
+            if (f[pq] >= 0) {
+              int p = pq / nm, q = pq % nm;
+              if (((i-1 < l) || (i-1 > u) || still(k,p,q,t)) &&
+                  (f[pq]+lc[t] > g[q*nm+t]))
+                g[q*nm+t] = f[pq]+lc[t];
+            }
+        }
+        if (st == 0)
+          break;
+      }
+      std::swap(f,g);
+    }
+    int v = -1;
+    for (int pq=nm*nm; pq--; )
+      v = std::max(v,f[pq]);
+    return v;
+  }
+
+public:
+  // Create propagator and initialize
+  StillLifeBound(Home home, ViewArray<IntView>& b0, int w0,
+                 int l0, int u0, IntView c0)
+    : Propagator(home), b(b0), w(w0), l(l0), u(u0), c(c0), co(home) {
+    ns = (u-l-2+strip) / strip;
+    sb = static_cast<Space&>(home).alloc<int>(ns);
+    sd = static_cast<Space&>(home).alloc<bool>(ns);
+    for (int s=ns; s--; ) {
+      sb[s]=0; sd[s]=true;
+    }
+    for (int i=b.size(); i--; )
+      if (!b[i].assigned())
+        b[i].subscribe(home,*new (home) Cell(home,*this,co,i));
+    // Advisors do not schedule the propagator, so do it here
+    IntView::schedule(home,*this,ME_INT_VAL);
+  }
+  // Post still-life bound propagator
+  static ExecStatus post(Home home, ViewArray<IntView>& b,
+                         int w, int l, int u, IntView c) {
+    // Cells are either dead or live
+    for (int i=b.size(); i--; ) {
+      GECODE_ME_CHECK(b[i].gq(home,0));
+      GECODE_ME_CHECK(b[i].lq(home,1));
+    }
+    // Only if there is something to count
+    if (u-l > 1)
+      (void) new (home) StillLifeBound(home,b,w,l,u,c);
+    return ES_OK;
+  }
+
+  // Copy constructor during cloning
+  StillLifeBound(Space& home, bool share, StillLifeBound& p)
+    : Propagator(home,share,p), w(p.w), l(p.l), u(p.u), ns(p.ns) {
+    b.update(home,share,p.b);
+    c.update(home,share,p.c);
+    co.update(home,share,p.co);
+    // Also copy the strips
+    sb = home.alloc<int>(ns);
+    sd = home.alloc<bool>(ns);
+    for (int s=ns; s--; ) {
+      sb[s]=p.sb[s]; sd[s]=p.sd[s];
+    }
+  }
+  // Create copy during cloning
+  virtual Propagator* copy(Space& home, bool share) {
+    return new (home) StillLifeBound(home,share,*this);
+  }
+
+  // Return cost (one dynamic program per strip)
+  virtual PropCost cost(const Space&, const ModEventDelta&) const {
+    return PropCost::linear(PropCost::HI, b.size());
+  }
+
+  // Record the strips that see the modified cell
+  virtual ExecStatus advise(Space& home, Advisor& a0, const Delta&) {
+    Cell& a = static_cast<Cell&>(a0);
+    int j = a.i % w;
+    for (int s=0; s<ns; s++)
+      if ((first(s)-1 <= j) && (j <= first(s)+width(s)))
+        sd[s] = true;
+    // A cell is assigned by any modification
+    return home.ES_NOFIX_DISPOSE(co,a);
+  }
+
+  // Perform propagation
+  virtual ExecStatus propagate(Space& home, const ModEventDelta&) {
+    int v = 0;
+    for (int s=0; s<ns; s++) {
+      if (sd[s]) {
+        sb[s] = solve(home,s);
+        if (sb[s] < 0)
+          return ES_FAILED;
+        sd[s] = false;
+      }
+      v += sb[s];
+    }
+    GECODE_ME_CHECK(c.lq(home,v));
+    // Once all cells are fixed the bound is exact
+    if (co.empty())
+      return home.ES_SUBSUMED(*this);
+    return ES_FIX;
+  }
+
+  // Dispose propagator and return its size
+  virtual size_t dispose(Space& home) {
+    for (Advisors<Cell> as(co); as(); ++as)
+      b[as.advisor().i].cancel(home,as.advisor());
+    co.dispose(home);
+    (void) Propagator::dispose(home);
+    return sizeof(*this);
+  }
+}; // end of class StillLifeBound
+
+/*
+ * Post the constraint that c is at most the number of live cells in
+ * rows and columns l+1 to u-1 of the board b of width w (row by row,
+ * 0/1 values) when the cells in rows and columns l to u are still.
+ */
+void stilllifebound(Home home, const IntVarArgs& b, int w, int l, int u,
+                    IntVar c) {
+  // Check whether the arguments make sense
+  if ((w <= 0) || (b.size() != w*w))
+    throw ArgumentSizeMismatch("stilllifebound");
+  if ((l < 1) || (u > w-2))
+    throw OutOfLimits("stilllifebound");
+  // Never post a propagator in a failed space
+  if (home.failed()) return;
+  // Set up array of views for the cells
+  ViewArray<IntView> vb(home,b);
+  // If posting failed, fail space
+  if (StillLifeBound::post(home,vb,w,l,u,c) != ES_OK)
+    home.fail();
+}